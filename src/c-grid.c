@@ -0,0 +1,105 @@
+/*
+
+find parameter c for the whole polar (r, t) grid of multipliers
+of one hyperbolic component
+for
+fc(z) = z^2+c
+
+batch version of give_c from c.c :
+instead of running m_d_interior from the nucleus for every grid node
+each node is seeded from the already solved neighbour node ( continuation ) :
+* radially : node (r_{i-1}, t) -> node (r_i, t)
+* angularly : node (r_i, t_{j-1}) -> node (r_i, t_j)
+the closer neighbour ( in the multiplier plane ) is used first, the other one is a fallback
+and the nucleus ( like in give_c ) is the last resort
+
+angular blocks of rays are solved in parallel ( OpenMP )
+a node which was not found is not used as a seed
+
+output is a dense array of c : cs[j*nr + i] = c( r_i, t_j)
+r_i = rMax*i/(nr-1) for i in [0, nr-1]
+t_j = j/nt for j in [0, nt-1]
+
+
+it can be used for :
+* conformal parametrization of the component
+* texture mapping : texture(r,t) -> component
+* internal rays and internal circles
+
+
+
+the grid is computed by m_interior_grid from multiplier library ( multiplier.c ) ,
+this program compares it with give_c from c.c ( m_interior ) node by node
+
+
+
+c console program
+
+make c-grid
+./c-grid
+
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <complex.h>
+#include <time.h>
+
+#include "multiplier.h"
+
+
+
+static double seconds(void){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+
+
+// *****************************************************
+
+int main (){
+
+	m_context ctx;
+	m_context_init(&ctx);
+
+	// input
+	int p= 4;
+	complex double center = 0.2822713907669138 +0.5300606175785252*I; // = nucleus = center of hyperbolic component of the Mandelbrot set with period p
+	const int nr = 64; // number of internal radii
+	const int nt = 256; // number of internal angles
+	const double rMax = 1.0;
+
+	// output
+	complex double *cs = malloc(nr*nt*sizeof(complex double));
+
+	double t0 = seconds();
+	int nFailed = m_interior_grid(&ctx, p, center, nr, rMax, nt, cs);
+	double t1 = seconds();
+
+	// check : the same grid node by node with give_c ( m_interior )
+	double maxDiff = 0.0;
+	int nDiffer = 0;
+	for (int j = 0; j < nt; j++)
+		for (int i = 0; i < nr; i++){
+			complex double c = m_interior(&ctx, p, center, (double) j/nt, rMax*i/(nr-1));
+			double d = cabs(c - cs[j*nr + i]);
+			if (d > 1e-10) nDiffer++;
+			else if (d > maxDiff) maxDiff = d;
+		}
+	double t2 = seconds();
+
+	printf ("input : \n");
+	printf ("\t period = %d center = %.16f%+.16f*I\n", p, creal(center), cimag(center));
+	printf ("\t grid : %d internal radii in [0, %f] x %d internal angles \n\n", nr, rMax, nt);
+	printf ("otput : \n");
+	printf ("\t c(r = %f, t = 0) = %.16f%+.16f*I\n", rMax, creal(cs[nr-1]), cimag(cs[nr-1]));
+	printf ("\t failed nodes = %d \n", nFailed);
+	printf ("\t time : grid = %f s \t node by node ( give_c ) = %f s\n", t1-t0, t2-t1);
+	printf ("\t max |c_grid - c_node| = %e \t nodes where give_c differs = %d\n", maxDiff, nDiffer);
+
+	free(cs);
+	return 0;
+}
@@ -0,0 +1,183 @@
+/*
+
+multiplier map with adaptive anti-aliasing
+using interior distance estimate from multiplier library ( m_multiplier_de )
+
+for
+fc(z) = z^2+c
+
+
+uniform supersampling computes nSub*nSub samples for every pixel
+here :
+* first one sample per pixel : multiplier m and interior distance estimate de
+* disk with radius de/4 is inside the component, so if de/4 is bigger then half of the pixel diagonal
+  the whole pixel is inside and one sample is enough
+* only other pixels are supersampled :
+  - interior pixels with de < 2*sqrt(2)*pixelSize
+  - exterior pixels ( de < 0 ) next to an interior pixel
+
+the image is also computed with uniform supersampling to compare time and colours
+
+
+colour :
+* interior : hue = internal angle = turn(m), brightness = internal radius = |m|
+* exterior of the component ( de < 0 : |m| >= 1 or the cycle of other component ) : white
+
+
+
+c console program
+
+make m-aa
+./m-aa
+
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <complex.h>
+#include <time.h>
+
+#include "multiplier.h"
+
+
+static const int iWidth = 600;
+static const int iHeight = 600;
+static const int nSub = 4; // supersampling : nSub*nSub samples per pixel
+
+// period 4 component
+static const int period = 4;
+static const complex double center = 0.2822713907669138 +0.5300606175785252*I;
+static const double radius = 0.05; // half of the window width
+
+
+
+static double seconds(void){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+
+static void give_colour(double *rgb, complex double m, double de){
+
+	double v = cabs(m);
+	if (! (de > 0.0)) { rgb[0] = rgb[1] = rgb[2] = 1.0; return; } // exterior of the component
+
+	// hsv to rgb with h = internal angle , s = 1, v = internal radius
+	double h = 6.0*m_turn(m);
+	int i = (int) h % 6;
+	double f = h - floor(h);
+	double p = 0.0, q = v*(1.0 - f), t = v*f;
+	switch (i) {
+		case 0: rgb[0] = v; rgb[1] = t; rgb[2] = p; break;
+		case 1: rgb[0] = q; rgb[1] = v; rgb[2] = p; break;
+		case 2: rgb[0] = p; rgb[1] = v; rgb[2] = t; break;
+		case 3: rgb[0] = p; rgb[1] = q; rgb[2] = v; break;
+		case 4: rgb[0] = t; rgb[1] = p; rgb[2] = v; break;
+		default: rgb[0] = v; rgb[1] = p; rgb[2] = q; break;
+	}
+}
+
+
+/* mean colour of nSub*nSub samples of pixel (ix, iy) */
+static void give_supersampled(const m_context *ctx, double *rgb, int ix, int iy, double pixelSize, complex double cMin){
+
+	double s[3];
+	double de;
+	rgb[0] = rgb[1] = rgb[2] = 0.0;
+
+	for (int j = 0; j < nSub; j++)
+		for (int i = 0; i < nSub; i++) {
+			complex double c = cMin + pixelSize*(ix + (i + 0.5)/nSub) + I*pixelSize*(iy + (j + 0.5)/nSub);
+			complex double m = m_multiplier_de(ctx, c, period, &de);
+			give_colour(s, m, de);
+			for (int k = 0; k < 3; k++) rgb[k] += s[k] / (nSub*nSub);
+		}
+}
+
+
+static void save(const char *name, const double *rgb){
+
+	FILE *fp = fopen(name, "wb");
+	if (! fp) { fprintf(stderr, "can not save %s\n", name); return; }
+	fprintf(fp, "P6\n%d %d\n255\n", iWidth, iHeight);
+	for (int iy = iHeight - 1; iy >= 0; iy--)
+		for (int ix = 0; ix < iWidth; ix++)
+			for (int k = 0; k < 3; k++) fputc((int) (255*rgb[3*(iy*iWidth + ix) + k] + 0.5), fp);
+	fclose(fp);
+}
+
+
+
+int main(void){
+
+	m_context ctx;
+	m_context_init(&ctx);
+
+	const int n = iWidth*iHeight;
+	const double pixelSize = 2.0*radius/iWidth;
+	const complex double cMin = center - radius - radius*I;
+	complex double *cs = malloc(n*sizeof(complex double));
+	complex double *ms = malloc(n*sizeof(complex double));
+	double *des = malloc(n*sizeof(double));
+	int *periods = malloc(n*sizeof(int));
+	double *adaptive = malloc(3*n*sizeof(double));
+	double *uniform = malloc(3*n*sizeof(double));
+	int nSupersampled = 0;
+
+	double t0 = seconds();
+
+	// one sample per pixel with distance estimate
+	for (int iy = 0; iy < iHeight; iy++)
+		for (int ix = 0; ix < iWidth; ix++) {
+			cs[iy*iWidth + ix] = cMin + pixelSize*(ix + 0.5) + I*pixelSize*(iy + 0.5);
+			periods[iy*iWidth + ix] = period;
+		}
+	m_multiplier_de_batch(&ctx, cs, periods, ms, des, n);
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:nSupersampled)
+	for (int iy = 0; iy < iHeight; iy++)
+		for (int ix = 0; ix < iWidth; ix++) {
+			const int k = iy*iWidth + ix;
+			const bool interior = des[k] > 0.0;
+			bool s = false;
+
+			if (interior) s = des[k] < 2.0*sqrt(2.0)*pixelSize;
+			else
+				for (int dy = -1; dy <= 1; dy++)
+					for (int dx = -1; dx <= 1; dx++) {
+						int jx = ix + dx, jy = iy + dy;
+						if (0 <= jx && jx < iWidth && 0 <= jy && jy < iHeight && des[jy*iWidth + jx] > 0.0) s = true;
+					}
+
+			if (s) { give_supersampled(&ctx, &adaptive[3*k], ix, iy, pixelSize, cMin); nSupersampled++; }
+			else give_colour(&adaptive[3*k], ms[k], des[k]);
+		}
+
+	double t1 = seconds();
+
+	// uniform supersampling of all pixels
+	#pragma omp parallel for schedule(dynamic)
+	for (int iy = 0; iy < iHeight; iy++)
+		for (int ix = 0; ix < iWidth; ix++)
+			give_supersampled(&ctx, &uniform[3*(iy*iWidth + ix)], ix, iy, pixelSize, cMin);
+
+	double t2 = seconds();
+
+	double maxDiff = 0.0;
+	for (int k = 0; k < 3*n; k++) if (fabs(adaptive[k] - uniform[k]) > maxDiff) maxDiff = fabs(adaptive[k] - uniform[k]);
+
+	save("m-aa.ppm", adaptive);
+
+	printf (" period = %d \t %d x %d pixels \t %d x %d samples per supersampled pixel\n", period, iWidth, iHeight, nSub, nSub);
+	printf (" supersampled pixels = %d ( %.1f %% ) \t samples : adaptive = %d \t uniform = %d\n", nSupersampled, 100.0*nSupersampled/n, n + nSub*nSub*nSupersampled, nSub*nSub*n);
+	printf (" time : adaptive = %f s \t uniform = %f s\n", t1 - t0, t2 - t1);
+	printf (" max colour difference adaptive - uniform = %f ( of 1 )\n", maxDiff);
+	printf (" image : m-aa.ppm\n");
+
+	free(cs); free(ms); free(des); free(periods); free(adaptive); free(uniform);
+	return 0;
+}
@@ -0,0 +1,499 @@
+/*
+
+multiplier map animation with temporal coherence across frames
+
+for
+fc(z) = z^2+c
+
+
+frames of the animation :
+* frames 0 ... nPan-1 : pan the window by whole pixels ( pixel size is not changed )
+* next frames : zoom in to the component
+* on every frame : internal ray of the component ( give_c from c.c ) with internal angle t = k/nFrames
+
+every frame is computed from the previous one :
+* pixel is copied if it's c is exactly the same as c of some pixel of the previous frame
+  window is snapped to the grid of pixel size, so after a pan by whole pixels c is bit for bit the same
+  and the result ( a function of c only ) provably did not change
+* other pixels use period and periodic point of the nearest pixel of the previous frame as a seed for Newton method
+  the seed is accepted only if Newton converges to an attracting cycle with exactly this period ( no smaller period divides it )
+* only when the seed fails the pixel is computed from scratch ( critical orbit, period detection, Newton )
+  both ways give the exact period of the attracting cycle , so every frame is the same as a frame computed from scratch
+  ( see check mode )
+* points of the internal ray are seeded with the ray of the previous frame ( continuation in the internal angle )
+
+frames are computed with OpenMP threads and saved ( ppm files ) by separate writer threads,
+so computing threads never wait for the disk ( unless all frame buffers are waiting to be saved )
+
+
+colour :
+* interior ( attracting cycle found ) : hue = internal angle = turn(m), brightness = internal radius = |m|
+* exterior ( escaping critical orbit ) : white
+* unknown ( no attracting cycle found or near neutral cycle ) : black
+* internal ray : white
+
+
+
+periodic points, multipliers and internal ray : multiplier library ( multiplier.h )
+
+
+
+c console program
+
+make m-anim
+./m-anim
+
+check mode : one frame ( default the last one ) is also computed from scratch ( without the previous frame ) and compared ,
+exit code 1 if some pixel differs ( the animation must not depend on the history of frames )
+./m-anim check [frame]
+
+convert to video :
+ffmpeg -framerate 25 -i m%05d.ppm -pix_fmt yuv420p m.mp4
+
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "multiplier.h"
+
+static const double twopi = 6.283185307179586;
+
+// image
+static const int iWidth = 400;
+static const int iHeight = 400;
+
+// animation
+static const int nFrames = 100;
+static const int nPan = 50; // number of pan frames
+static const int panPixels = 3; // pan step in pixels
+static const double zoomFactor = 0.97; // pixel size change per zoom frame
+
+// hyperbolic component for the internal ray
+static const int pRay = 4;
+static const complex double center = 0.2822713907669138 +0.5300606175785252*I; // nucleus
+static const int nRay = 200; // points of internal ray
+
+// algorithm parameters ( Newton and exact period : m_context of multiplier library )
+static m_context ctx; // read only after m_context_init
+static const int iMaxOrbit = 2048; // iterations of critical orbit before period detection
+static const int iMaxOrbitSlow = 32768; // and before the second period detection if the first one failed
+static const int pMax = 256; // maximal period
+static const double candidateEps2 = 1e-6; // period detection : |f^p(z) - z|^2 < candidateEps2
+static const int maxCandidates = 4; // periods tried with Newton method
+static const double neutral = 1e-3; // near neutral cycles ( |m| >= 1 - neutral ) are unknown : the critical orbit converges too slowly for period detection
+static const double mEps = 1e-9; // check mode : multipliers of the same pixel are the same if |m1 - m2| < mEps
+
+// frame buffers and writer threads
+#define nBuffers 4
+#define nWriters 2
+
+
+
+// pixel state = what the next frame can reuse
+typedef struct {
+	complex double c;
+	complex double zp; // periodic point
+	complex double m; // multiplier
+	int period; // 0 = exterior, -1 = unknown
+} pixel;
+
+
+
+// window = pixels with c = step*(gx + I*gy) for integer gx in [gx0, gx0 + iWidth) , gy in [gy0, gy0 + iHeight)
+typedef struct {
+	double step; // pixel size
+	long gx0;
+	long gy0;
+} window;
+
+
+
+// ***************************************************************
+// pixel : periodic point and multiplier from multiplier library ( m.c )
+
+
+/*
+  try period and seed from previous frame
+  returns true if the pixel is interior with that period
+*/
+bool give_pixel_seeded(pixel *px, const complex double c, const pixel *seed){
+
+	complex double zp;
+
+	if (seed->period <= 0) return false;
+	if (! m_periodic(&ctx, c, seed->zp, seed->period, &zp)) return false;
+
+	complex double m = m_multiplier_at(c, zp, seed->period);
+	if (! (cabs(m) < 1.0 - neutral)) return false;
+	if (m_exact_period(&ctx, c, zp, seed->period) != seed->period) return false;
+
+	px->zp = zp;
+	px->m = m;
+	px->period = seed->period;
+	return true;
+}
+
+
+/*
+  attracting cycle from Newton method with the candidate period p from the point z of the critical orbit
+  returns true if found , then the period of px is the exact period of the cycle ( a divisor of p )
+*/
+bool give_attracting(pixel *px, const complex double c, const complex double z, const int p){
+
+	complex double zp;
+
+	if (! m_periodic(&ctx, c, z, p, &zp)) return false;
+	if (! (cabs(m_multiplier_at(c, zp, p)) < 1.0 - neutral)) return false;
+
+	const int q = m_exact_period(&ctx, c, zp, p);
+	px->zp = zp;
+	px->m = m_multiplier_at(c, zp, q);
+	px->period = q;
+	return true;
+}
+
+
+/*
+  period detection from the point z of the critical orbit
+  near returns of the orbit are only candidates for the period ( near the boundary the orbit converges slowly ) ,
+  Newton decides : the first candidate which gives an attracting cycle is reduced to the exact period of that cycle ,
+  so the result is the same as the one of a seeded pixel ( the attracting cycle is unique )
+*/
+bool give_period(pixel *px, const complex double c, const complex double z){
+
+	// near returns , then the nearest return
+	complex double w = z;
+	int nCandidates = 0;
+	int pNearest = 1;
+	double d2Nearest = INFINITY;
+	for (int p = 1; p <= pMax && nCandidates < maxCandidates; p++) {
+		w = w*w + c;
+		const double d2 = m_cabs2(w - z);
+		if (d2 < d2Nearest) { d2Nearest = d2; pNearest = p; }
+		if (d2 < candidateEps2) {
+			nCandidates++;
+			if (give_attracting(px, c, z, p)) return true;
+		}
+	}
+	return d2Nearest >= candidateEps2 && give_attracting(px, c, z, pNearest);
+}
+
+
+/*
+  pixel from scratch : critical orbit, period detection, Newton from the last point of the orbit
+  if the period is not found the orbit is iterated longer and the period detection is done again
+*/
+void give_pixel_cold(pixel *px, const complex double c){
+
+	complex double z = 0.0; // critical point
+
+	px->period = -1;
+	px->zp = 0.0;
+	px->m = 0.0;
+
+	for (int i = 0; i < iMaxOrbitSlow; i++) {
+		z = z*z + c;
+		if (m_cabs2(z) > ctx.er2) { px->period = 0; return; } // exterior
+		if (i == iMaxOrbit - 1 && give_period(px, c, z)) return;
+	}
+	give_period(px, c, z);
+}
+
+
+
+enum reuse { copied, seeded, cold };
+
+
+/*
+  pixel px with given c from the previous frame prev ( NULL for the first frame )
+  ix, iy = pixel of the frame with window w
+*/
+enum reuse give_pixel(pixel *px, const pixel *prev, const window *w, const window *wPrev, int ix, int iy){
+
+	if (prev) {
+		// pixel of the previous frame with the same c ( or nearest c )
+		const bool samePixels = (w->step == wPrev->step);
+		long jx = samePixels ? w->gx0 + ix - wPrev->gx0 : lround(creal(px->c)/wPrev->step) - wPrev->gx0;
+		long jy = samePixels ? w->gy0 + iy - wPrev->gy0 : lround(cimag(px->c)/wPrev->step) - wPrev->gy0;
+		if (0 <= jx && jx < iWidth && 0 <= jy && jy < iHeight) {
+			const pixel *old = &prev[jy*iWidth + jx];
+			if (old->c == px->c) { *px = *old; return copied; }
+			if (give_pixel_seeded(px, px->c, old)) return seeded;
+		}
+	}
+	give_pixel_cold(px, px->c);
+	return cold;
+}
+
+
+
+// ***************************************************************
+// internal ray : c.c
+
+
+/*
+  internal ray with internal angle t : nRay points with internal radius r_i = i/nRay
+  zs, cs = ray of the previous frame ( seeds ) on input and the new ray on output
+  first frame : zs = 0, cs = center
+*/
+void give_ray(complex double *zs, complex double *cs, double t){
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nRay; i++) {
+		complex double m = ((double) i/nRay) * cexp(I*twopi*t);
+		complex double z, c;
+		if (m_converged != m_d_interior(&z, &c, zs[i], cs[i], m, pRay, ctx.maxsteps))
+			m_d_interior(&z, &c, 0.0, center, m, pRay, ctx.maxsteps); // like aproximate_c
+		zs[i] = z;
+		cs[i] = c;
+	}
+}
+
+
+
+// ***************************************************************
+// frame writer threads
+
+
+typedef struct {
+	unsigned char *rgb; // iWidth*iHeight*3
+	int frame; // frame number, -1 = buffer is free
+} frame_buffer;
+
+
+static frame_buffer buffers[nBuffers];
+static int queue[nBuffers]; // indices of buffers waiting to be saved ( fifo )
+static int queueHead = 0;
+static int queueLength = 0;
+static bool finished = false;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queueNotEmpty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t bufferFree = PTHREAD_COND_INITIALIZER;
+
+
+
+void *writer(void *arg){
+
+	(void) arg;
+	char name[64];
+
+	for (;;) {
+		pthread_mutex_lock(&lock);
+		while (queueLength == 0 && ! finished)
+			pthread_cond_wait(&queueNotEmpty, &lock);
+		if (queueLength == 0) { pthread_mutex_unlock(&lock); return NULL; } // finished
+		int b = queue[queueHead];
+		queueHead = (queueHead + 1) % nBuffers;
+		queueLength--;
+		pthread_mutex_unlock(&lock);
+
+		snprintf(name, sizeof(name), "m%05d.ppm", buffers[b].frame);
+		FILE *fp = fopen(name, "wb");
+		if (fp) {
+			fprintf(fp, "P6\n%d %d\n255\n", iWidth, iHeight);
+			fwrite(buffers[b].rgb, 1, (size_t) iWidth*iHeight*3, fp);
+			fclose(fp);
+		}
+		else fprintf(stderr, "can not save %s\n", name);
+
+		pthread_mutex_lock(&lock);
+		buffers[b].frame = -1;
+		pthread_cond_signal(&bufferFree);
+		pthread_mutex_unlock(&lock);
+	}
+}
+
+
+// wait for a free buffer
+int get_buffer(void){
+
+	pthread_mutex_lock(&lock);
+	for (;;) {
+		for (int b = 0; b < nBuffers; b++)
+			if (buffers[b].frame < 0) {
+				buffers[b].frame = -2; // taken by computing thread
+				pthread_mutex_unlock(&lock);
+				return b;
+			}
+		pthread_cond_wait(&bufferFree, &lock);
+	}
+}
+
+
+void put_buffer(int b, int frame){
+
+	pthread_mutex_lock(&lock);
+	buffers[b].frame = frame;
+	queue[(queueHead + queueLength) % nBuffers] = b;
+	queueLength++;
+	pthread_cond_signal(&queueNotEmpty);
+	pthread_mutex_unlock(&lock);
+}
+
+
+
+// ***************************************************************
+// frame
+
+
+window give_window(int k){
+
+	window w;
+	const double step0 = 0.3 / iWidth;
+	// low left corner of the first frame : last pan frame has the component in the middle
+	const complex double c0 = center - 0.15 - 0.15*I - step0*panPixels*(nPan - 1);
+
+	if (k < nPan) {
+		w.step = step0;
+		w.gx0 = lround(creal(c0)/step0) + (long) k*panPixels;
+		w.gy0 = lround(cimag(c0)/step0);
+	}
+	else {
+		// zoom in to the center of the component
+		w.step = step0 * pow(zoomFactor, k - nPan + 1);
+		w.gx0 = lround(creal(center)/w.step) - iWidth/2;
+		w.gy0 = lround(cimag(center)/w.step) - iHeight/2;
+	}
+	return w;
+}
+
+
+void give_colour(unsigned char *rgb, const pixel *px){
+
+	if (px->period == 0) { rgb[0] = rgb[1] = rgb[2] = 255; return; }
+	if (px->period < 0) { rgb[0] = rgb[1] = rgb[2] = 0; return; }
+
+	// hsv to rgb with h = internal angle , s = 1, v = internal radius
+	double h = 6.0*m_turn(px->m);
+	double v = cabs(px->m);
+	int i = (int) h % 6;
+	double f = h - floor(h);
+	double p = 0.0, q = v*(1.0 - f), t = v*f;
+	double r, g, b;
+	switch (i) {
+		case 0: r = v; g = t; b = p; break;
+		case 1: r = q; g = v; b = p; break;
+		case 2: r = p; g = v; b = t; break;
+		case 3: r = p; g = q; b = v; break;
+		case 4: r = t; g = p; b = v; break;
+		default: r = v; g = p; b = q; break;
+	}
+	rgb[0] = 255*r;
+	rgb[1] = 255*g;
+	rgb[2] = 255*b;
+}
+
+
+
+static double seconds(void){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+
+
+// *****************************************************
+
+int main (int argc, char **argv){
+
+	const bool check = argc > 1 && strcmp(argv[1], "check") == 0;
+	const int checkFrame = argc > 2 ? atoi(argv[2]) : nFrames - 1;
+	m_context_init(&ctx);
+	const int n = iWidth*iHeight;
+	pixel *prev = malloc(n*sizeof(pixel));
+	pixel *next = malloc(n*sizeof(pixel));
+	complex double zRay[nRay], cRay[nRay];
+	window wPrev = {0.0, 0, 0};
+	long nCopied = 0, nSeeded = 0, nCold = 0;
+	long nDiffer = 0; // check mode : pixels different from scratch
+	int maxColourDiff = 0;
+	pthread_t writers[nWriters];
+
+	for (int b = 0; b < nBuffers; b++) {
+		buffers[b].rgb = malloc((size_t) n*3);
+		buffers[b].frame = -1;
+	}
+	for (int i = 0; i < nWriters; i++) pthread_create(&writers[i], NULL, writer, NULL);
+	for (int i = 0; i < nRay; i++) { zRay[i] = 0.0; cRay[i] = center; }
+
+	double t0 = seconds();
+
+	for (int k = 0; k < nFrames; k++) {
+
+		const window w = give_window(k);
+		const int b = get_buffer();
+		unsigned char *rgb = buffers[b].rgb;
+
+		#pragma omp parallel for schedule(dynamic) reduction(+:nCopied,nSeeded,nCold)
+		for (int iy = 0; iy < iHeight; iy++)
+			for (int ix = 0; ix < iWidth; ix++) {
+
+				pixel *px = &next[iy*iWidth + ix];
+				px->c = w.step*(w.gx0 + ix) + I*w.step*(w.gy0 + iy);
+
+				switch (give_pixel(px, k > 0 ? prev : NULL, &w, &wPrev, ix, iy)) {
+					case copied: nCopied++; break;
+					case seeded: nSeeded++; break;
+					default: nCold++;
+				}
+
+				give_colour(&rgb[3*((iHeight - 1 - iy)*iWidth + ix)], px);
+			}
+
+		if (check && k == checkFrame) {
+			#pragma omp parallel for schedule(dynamic) reduction(+:nDiffer) reduction(max:maxColourDiff)
+			for (int i = 0; i < n; i++) {
+				pixel px = next[i];
+				unsigned char a[3], b[3];
+				give_pixel_cold(&px, px.c);
+				give_colour(a, &next[i]);
+				give_colour(b, &px);
+				if (px.period != next[i].period || cabs(px.m - next[i].m) > mEps) nDiffer++;
+				for (int j = 0; j < 3; j++) if (abs(a[j] - b[j]) > maxColourDiff) maxColourDiff = abs(a[j] - b[j]);
+			}
+		}
+
+		// internal ray : seeded with the ray of the previous frame
+		give_ray(zRay, cRay, (double) k/nFrames);
+		for (int i = 0; i < nRay; i++) {
+			long ix = lround(creal(cRay[i])/w.step) - w.gx0;
+			long iy = lround(cimag(cRay[i])/w.step) - w.gy0;
+			if (0 <= ix && ix < iWidth && 0 <= iy && iy < iHeight)
+				memset(&rgb[3*((iHeight - 1 - iy)*iWidth + ix)], 255, 3);
+		}
+
+		put_buffer(b, k);
+
+		pixel *tmp = prev; prev = next; next = tmp;
+		wPrev = w;
+	}
+
+	double t1 = seconds();
+
+	pthread_mutex_lock(&lock);
+	finished = true;
+	pthread_cond_broadcast(&queueNotEmpty);
+	pthread_mutex_unlock(&lock);
+	for (int i = 0; i < nWriters; i++) pthread_join(writers[i], NULL);
+
+	double t2 = seconds();
+
+	printf (" %d frames %d x %d \t files m00000.ppm ... m%05d.ppm\n", nFrames, iWidth, iHeight, nFrames - 1);
+	printf (" pixels : copied = %ld \t seeded from previous frame = %ld \t from scratch = %ld\n", nCopied, nSeeded, nCold);
+	printf (" time : compute = %f s \t waiting for writers at the end = %f s\n", t1 - t0, t2 - t1);
+	if (check) printf (" check : frame %d \t pixels different from scratch = %ld ( period or |m| difference > %g ) \t max colour difference = %d\n", checkFrame, nDiffer, mEps, maxColourDiff);
+
+	for (int b = 0; b < nBuffers; b++) free(buffers[b].rgb);
+	free(prev);
+	free(next);
+	return check && nDiffer > 0;
+}
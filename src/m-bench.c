@@ -0,0 +1,516 @@
+/*
+
+benchmark and validation of the kernels of multiplier library ( multiplier.h )
+accuracy and throughput together, so a faster kernel can be accepted or rejected by measured error
+
+for
+fc(z) = z^2+c
+
+
+workloads :
+* closed forms for periods 1 and 2 :
+  random multiplier m , c = (2m - m^2)/4 ( period 1 ) , c = (m - 4)/4 ( period 2 )
+  numerical kernels must give back m ( from c ) and c ( from m )
+* known period : m_period_batch of all points of closed forms and round trips must give their period
+  ( max error column = number of wrong periods , threshold 0 )
+* round trips for periods 3 ... pMax :
+  nuclei of components are found with Newton method ( f^p(0) = 0 ), random m inside the unit disk ,
+  c = m_interior(m) , then every multiplier kernel must give back m ( c -> m -> c )
+* wrong seeds for the round trip points : a point of a repelling cycle with the same period ( and ctx.nSeeds points of it ) ,
+  Newton from it alone finds the repelling cycle , m_multiplier_seeded_batch must find the attracting one with multi-start
+  ( the number of rescued points is printed , 0 rescued is a failure : the workload would not test the fallback )
+* high precision reference : multiplier from long double Newton
+  ( and c from long double m_d_interior_step ) started from the double result
+
+for every kernel and workload : number of points, throughput, max error , threshold and PASS / FAIL
+fast variants ( mixed precision ) also print their speedup = throughput / throughput of the double kernel
+( m_multiplier_batch ) on the same workload , and SLOW instead of PASS if it is below 1
+exit code is 1 if any kernel is above it's threshold , 2 if all are below but a fast variant is slower than double
+
+
+c console program
+
+make check
+./m-bench [points per workload]
+
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <complex.h>
+#include <time.h>
+
+#include "multiplier.h"
+
+
+static const int pMax = 8; // periods of round trips : 3 ... pMax
+#define nMaxNuclei 4 // components per period
+static const double rMax = 0.9; // internal radius of random multipliers
+
+// thresholds of max error of multiplier from c in double , index = period
+// rounding grows with period ( |dm/dc| and |dm/dz| are bigger in smaller components ) but not monotonically ,
+// so every period has it's own : about 3 times the measured max error of all kernels ( default workload , 20000 points )
+// measured : 2.0e-15 2.4e-15 2.5e-13 7.8e-12 1.8e-12 3.1e-11 5.7e-10 3.4e-10
+static const double errDouble[] = { 0.0, 6e-15, 7e-15, 7e-13, 2.5e-11, 6e-12, 1e-10, 1.7e-9, 1e-9 };
+static const double errInterior = 1e-14; // c from multiplier
+
+static const double twopi = 6.283185307179586;
+
+static int nFailed = 0; // kernels above threshold
+static int nSlow = 0; // fast variants slower than their double baseline
+
+
+
+static double seconds(void){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+
+// random numbers : splitmix64 of the index , the same workload on every run
+static double give_random(uint64_t i){
+
+	uint64_t z = i + 0x9e3779b97f4a7c15ULL;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	z = z ^ (z >> 31);
+	return (z >> 11) * 0x1.0p-53; // [0, 1)
+}
+
+
+/* random multiplier inside the disk with radius rMax */
+static complex double give_random_multiplier(uint64_t i){
+
+	return rMax * sqrt(give_random(2*i)) * cexp(I*twopi*give_random(2*i + 1));
+}
+
+
+static double give_threshold(int period){
+
+	return errDouble[period];
+}
+
+
+static double max_error(const complex double *a, const complex double *b, int n){
+
+	double e = 0.0;
+	for (int k = 0; k < n; k++) {
+		double d = cabs(a[k] - b[k]);
+		if (! (d <= e)) e = d; // NaN is the biggest error
+	}
+	return e;
+}
+
+
+/* fast variant : tDouble = time of the double kernel for the same points , speedup column and SLOW below 1 */
+static void report_speedup(const char *kernel, const char *workload, int n, double t, double err, double threshold, double tDouble){
+
+	const bool pass = err <= threshold;
+	const bool slow = t > tDouble;
+	if (! pass) nFailed++;
+	else if (slow) nSlow++;
+	printf (" %-26s %-22s %8d %12.0f %12.3e %10.1e %8.2f  %s\n", kernel, workload, n, n/t, err, threshold, tDouble/t, ! pass ? "FAIL" : slow ? "SLOW" : "PASS");
+}
+
+
+static void report(const char *kernel, const char *workload, int n, double t, double err, double threshold){
+
+	bool pass = err <= threshold;
+	if (! pass) nFailed++;
+	printf (" %-26s %-22s %8d %12.0f %12.3e %10.1e %8s  %s\n", kernel, workload, n, n/t, err, threshold, "-", pass ? "PASS" : "FAIL");
+}
+
+
+
+// ***************************************************************************************
+// high precision reference ( long double )
+
+
+/* multiplier of the attracting cycle near zp , long double Newton from the double periodic point */
+static complex double give_reference_multiplier(complex double c0, complex double zp, int period){
+
+	const complex long double c = c0;
+	complex long double z0 = zp;
+
+	for (int n = 0; n < 8; n++) {
+		complex long double z = z0, d = 1.0L;
+		for (int p = 0; p < period; p++) { d = 2*z*d; z = z*z + c; }
+		z0 = z0 - (z - z0)/(d - 1);
+	}
+
+	complex long double z = z0, d = 1.0L;
+	for (int p = 0; p < period; p++) { d = 2*z*d; z = z*z + c; }
+	return d;
+}
+
+
+/* c for multiplier m , long double Newton ( m_d_interior_step ) from the double solution (z, c) */
+static complex double give_reference_c(complex double z0, complex double c0, complex double multiplier, int period){
+
+	complex long double zg = z0, cg = c0;
+	const complex long double m = multiplier;
+
+	for (int n = 0; n < 8; n++) {
+		complex long double c = cg, z = zg, dz = 1, dc = 0, dzdz = 0, dcdz = 0;
+		for (int p = 0; p < period; ++p) {
+			dcdz = 2 * (z * dcdz + dc * dz);
+			dzdz = 2 * (z * dzdz + dz * dz);
+			dc = 2 * z * dc + 1;
+			dz = 2 * z * dz;
+			z = z * z + c;
+		}
+		complex long double det = (dz - 1) * dcdz - dc * dzdz;
+		complex long double z_new = zg - (dcdz * (z - zg) - dc * (dz - m)) / det;
+		complex long double c_new = cg - ((dz - 1) * (dz - m) - dzdz * (z - zg)) / det;
+		zg = z_new;
+		cg = c_new;
+	}
+	return cg;
+}
+
+
+
+// ***************************************************************************************
+// nuclei
+
+
+/* nucleus of period p from the seed c : Newton for f^p(0) = 0 , false if not found or the period is smaller */
+static bool give_nucleus(complex double *nucleus, complex double c, int period){
+
+	for (int n = 0; n < 64; n++) {
+		complex double z = 0.0, dc = 0.0;
+		for (int p = 0; p < period; p++) { dc = 2*z*dc + 1; z = z*z + c; }
+		complex double cNew = c - z/dc;
+		if (! (cabs(cNew) < 4.0)) return false;
+		if (cabs(cNew - c) < 1e-15) {
+			// exact period
+			z = 0.0;
+			for (int q = 1; q < period; q++) { z = z*z + cNew; if (period % q == 0 && cabs(z) < 1e-10) return false; }
+			*nucleus = cNew;
+			return true;
+		}
+		c = cNew;
+	}
+	return false;
+}
+
+
+static int give_nuclei(complex double *nuclei, int period){
+
+	int n = 0;
+
+	for (uint64_t i = 0; i < 4096 && n < nMaxNuclei; i++) {
+		complex double c = -2.0 + 2.5*give_random(1000000 + 2*i) + I*1.25*give_random(1000000 + 2*i + 1);
+		complex double nucleus;
+		if (! give_nucleus(&nucleus, c, period)) continue;
+		bool known = false;
+		for (int k = 0; k < n; k++) if (cabs(nuclei[k] - nucleus) < 1e-10) known = true;
+		if (! known) nuclei[n++] = nucleus;
+	}
+	return n;
+}
+
+
+
+// ***************************************************************************************
+// workloads
+
+
+/*
+  m_period_batch on points with known period , max error column = number of wrong periods
+  internal radius <= rMax : the critical orbit is near the cycle long before iMax = 10000 ( default 10^6 is only slow )
+*/
+static void periods_known(const m_context *ctx, const complex double *cs, int n, int period, const char *workload){
+
+	int *periods = malloc(n*sizeof(int));
+	m_context shortCtx = *ctx;
+	shortCtx.iMax = 10000;
+
+	double t = seconds();
+	m_period_batch(&shortCtx, cs, periods, n);
+	t = seconds() - t;
+
+	int nWrong = 0;
+	for (int k = 0; k < n; k++) if (periods[k] != period) nWrong++;
+	report("m_period_batch", workload, n, t, nWrong, 0.0);
+
+	free(periods);
+}
+
+
+
+static void closed_forms(const m_context *ctx, int n){
+
+	complex double *ms = malloc(n*sizeof(complex double)); // exact multipliers
+	complex double *cs = malloc(n*sizeof(complex double)); // exact c
+	complex double *out = malloc(n*sizeof(complex double));
+	int *periods = malloc(n*sizeof(int));
+	double t;
+	char workload[64];
+
+	for (int period = 1; period <= 2; period++) {
+
+		const complex double nucleus = period == 1 ? 0.0 : -1.0;
+		snprintf(workload, sizeof(workload), "closed form p = %d", period);
+
+		for (int k = 0; k < n; k++) {
+			ms[k] = give_random_multiplier(k);
+			cs[k] = period == 1 ? (2.0*ms[k] - ms[k]*ms[k])/4.0 : (ms[k] - 4.0)/4.0;
+			periods[k] = period;
+		}
+
+		periods_known(ctx, cs, n, period, workload);
+
+		// c -> m
+		t = seconds();
+		m_multiplier_batch(ctx, cs, periods, out, n);
+		report("m_multiplier ( explicit )", workload, n, seconds() - t, max_error(out, ms, n), give_threshold(period));
+
+		t = seconds();
+		#pragma omp parallel for schedule(dynamic, 64)
+		for (int k = 0; k < n; k++) {
+			complex double zp;
+			// period 2 : Newton for f^2 from 0 can find the fixed point , so start from the late critical orbit
+			complex double z0 = 0.0;
+			if (period == 2) for (int i = 0; i < 64; i++) z0 = z0*z0 + cs[k];
+			m_periodic(ctx, cs[k], z0, period, &zp);
+			out[k] = m_multiplier_at(cs[k], zp, period);
+		}
+		report("m_periodic ( Newton )", workload, n, seconds() - t, max_error(out, ms, n), give_threshold(period));
+
+		t = seconds();
+		#pragma omp parallel for schedule(dynamic, 64)
+		for (int k = 0; k < n; k++) {
+			complex double zp;
+			if (! m_periodic_multistart(ctx, cs[k], period, NULL, 0, &zp, &out[k])) out[k] = NAN;
+		}
+		report("m_periodic_multistart", workload, n, seconds() - t, max_error(out, ms, n), give_threshold(period));
+
+		t = seconds();
+		m_multiplier_de_batch(ctx, cs, periods, out, NULL, n);
+		report("m_multiplier_de_batch", workload, n, seconds() - t, max_error(out, ms, n), give_threshold(period));
+
+		// m -> c
+		t = seconds();
+		#pragma omp parallel for schedule(dynamic, 64)
+		for (int k = 0; k < n; k++) {
+			complex double z;
+			if (m_converged != m_d_interior(&z, &out[k], 0.0, nucleus, ms[k], period, ctx->maxsteps)) out[k] = NAN;
+		}
+		report("m_d_interior ( Newton )", workload, n, seconds() - t, max_error(out, cs, n), errInterior);
+	}
+
+	free(ms);
+	free(cs);
+	free(out);
+	free(periods);
+}
+
+
+
+/*
+  seeds in a wrong basin : points of a repelling cycle with the same period
+  Newton from such seed alone stays on the repelling cycle , multi-start must find the attracting one
+  one seed , and ctx->nSeeds seeds ( the points of the repelling cycle , repeated ) : caller seeds must not take
+  the lane of the late critical orbit
+  points without such a cycle ( not found from 16 random starts ) are skipped
+*/
+static void wrong_seeds(const m_context *ctx, const complex double *cs, const complex double *ref, int n, int period){
+
+	const int nSeedsMax = ctx->nSeeds > 1 ? ctx->nSeeds : 1;
+	complex double *cw = malloc(n*sizeof(complex double));
+	complex double *rw = malloc(n*sizeof(complex double));
+	complex double *seeds = malloc(n*sizeof(complex double)); // one point of the repelling cycle
+	complex double *seedsN = malloc((size_t) n*nSeedsMax*sizeof(complex double));
+	complex double *out = malloc(n*sizeof(complex double));
+	complex double *singleOut = malloc(n*sizeof(complex double));
+	int *periods = malloc(n*sizeof(int));
+	bool *found = malloc(n*sizeof(bool));
+	m_context single = *ctx;
+	single.nSeeds = 0; // Newton from the first seed only
+	char workload[64];
+
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int k = 0; k < n; k++) {
+		found[k] = false;
+		for (uint64_t i = 0; i < 16 && ! found[k]; i++) {
+			complex double z0 = 2.0 * sqrt(give_random(2000000 + 32*(uint64_t)k + 2*i)) * cexp(I*twopi*give_random(2000000 + 32*(uint64_t)k + 2*i + 1));
+			found[k] = m_periodic(ctx, cs[k], z0, period, &seeds[k])
+				&& cabs(m_multiplier_at(cs[k], seeds[k], period)) > 1.0
+				&& m_exact_period(ctx, cs[k], seeds[k], period) == period;
+		}
+	}
+
+	int nw = 0;
+	for (int k = 0; k < n; k++) if (found[k]) { cw[nw] = cs[k]; rw[nw] = ref[k]; seeds[nw] = seeds[k]; periods[nw] = period; nw++; }
+
+	for (int nS = 1; nS <= nSeedsMax; nS = nS == nSeedsMax ? nSeedsMax + 1 : nSeedsMax) {
+
+		snprintf(workload, sizeof(workload), "wrong seeds x%d p = %d", nS, period);
+		for (int k = 0; k < nw; k++) {
+			complex double z = seeds[k];
+			for (int j = 0; j < nS; j++) { seedsN[(size_t) k*nS + j] = z; z = z*z + cw[k]; }
+		}
+
+		// Newton from the wrong seed alone
+		m_multiplier_seeded_batch(&single, cw, periods, seedsN, nS, singleOut, nw);
+
+		double t = seconds();
+		m_multiplier_seeded_batch(ctx, cw, periods, seedsN, nS, out, nw);
+		t = seconds() - t;
+		report("m_multiplier_seeded_batch", workload, nw, t, nw ? max_error(out, rw, nw) : INFINITY, give_threshold(period));
+
+		// the workload must test the fallback : points where Newton from the seed alone fails and multi-start does not
+		int nRescued = 0;
+		for (int k = 0; k < nw; k++)
+			if (! (cabs(singleOut[k] - rw[k]) <= give_threshold(period)) && cabs(out[k] - rw[k]) <= give_threshold(period)) nRescued++;
+		printf (" %-26s %-22s %8d rescued by multi-start\n", "", "", nRescued);
+		if (nRescued == 0) nFailed++;
+	}
+
+	free(cw); free(rw); free(seeds); free(seedsN); free(out); free(singleOut); free(periods); free(found);
+}
+
+
+
+static void round_trips(const m_context *ctx, int n){
+
+	complex double *ms = malloc(n*sizeof(complex double)); // multipliers
+	complex double *cs = malloc(n*sizeof(complex double)); // c from multiplier
+	complex double *zs = malloc(n*sizeof(complex double)); // periodic points of c
+	complex double *out = malloc(n*sizeof(complex double));
+	complex double *ref = malloc(n*sizeof(complex double)); // long double c , then long double m
+	complex double *centers = malloc(n*sizeof(complex double));
+	double *angles = malloc(n*sizeof(double));
+	double *radii = malloc(n*sizeof(double));
+	int *periods = malloc(n*sizeof(int));
+	complex double nuclei[nMaxNuclei];
+	double t;
+	char workload[64];
+	char kernel[64];
+
+	for (int period = 3; period <= pMax; period++) {
+
+		const int nNuclei = give_nuclei(nuclei, period);
+		const double err = give_threshold(period);
+		if (nNuclei == 0) { report("give_nuclei", "no nucleus", 0, 1.0, INFINITY, 0.0); continue; }
+		snprintf(workload, sizeof(workload), "round trip p = %d", period);
+
+		for (int k = 0; k < n; k++) {
+			ms[k] = give_random_multiplier(period*n + k);
+			centers[k] = nuclei[k % nNuclei];
+			angles[k] = m_turn(ms[k]);
+			radii[k] = cabs(ms[k]);
+			periods[k] = period;
+		}
+
+		// m -> c
+		t = seconds();
+		m_interior_batch(ctx, periods, centers, angles, radii, cs, n);
+		t = seconds() - t;
+		#pragma omp parallel for schedule(dynamic, 64)
+		for (int k = 0; k < n; k++) {
+			m_d_interior(&zs[k], &out[k], 0.0, centers[k], ms[k], period, ctx->maxsteps);
+			ref[k] = give_reference_c(zs[k], out[k], ms[k], period);
+		}
+		report("m_interior_batch", workload, n, t, max_error(cs, ref, n), errInterior);
+
+		periods_known(ctx, cs, n, period, workload);
+
+		// c -> m : the reference starts from the periodic point of m_d_interior ( the cycle with multiplier m )
+		#pragma omp parallel for schedule(dynamic, 64)
+		for (int k = 0; k < n; k++) ref[k] = give_reference_multiplier(cs[k], zs[k], period);
+
+		t = seconds();
+		m_multiplier_batch(ctx, cs, periods, out, n);
+		t = seconds() - t;
+		const double tDouble = t; // baseline of the mixed precision
+		report("m_multiplier_batch", workload, n, t, max_error(out, ref, n), err);
+		// m -> c -> m , also with the rounding of c
+		report("m -> c -> m", workload, n, t, max_error(out, ms, n), err);
+
+		t = seconds();
+		#pragma omp parallel for schedule(dynamic, 64)
+		for (int k = 0; k < n; k++) {
+			complex double zp;
+			if (! m_periodic_multistart(ctx, cs[k], period, NULL, 0, &zp, &out[k])) out[k] = NAN;
+		}
+		report("m_periodic_multistart", workload, n, seconds() - t, max_error(out, ref, n), err);
+
+		t = seconds();
+		m_multiplier_de_batch(ctx, cs, periods, out, NULL, n);
+		report("m_multiplier_de_batch", workload, n, seconds() - t, max_error(out, ref, n), err);
+
+		wrong_seeds(ctx, cs, ref, n, period);
+
+		// mixed precision : points with estimated error above tolerance are recomputed in double
+		t = seconds();
+		const int nDouble = m_multiplier_mixed_batch(ctx, cs, out, n, period);
+		t = seconds() - t;
+		snprintf(kernel, sizeof(kernel), "mixed ( %d%% double )", (int) (100.0*nDouble/n));
+		report_speedup(kernel, workload, n, t, max_error(out, ref, n), ctx->tolerance, tDouble);
+	}
+
+	free(ms); free(cs); free(zs); free(out); free(ref); free(centers); free(angles); free(radii); free(periods);
+}
+
+
+
+/* polar grid with continuation must give the same c as m_interior node by node */
+static void grids(const m_context *ctx, int n){
+
+	const int nt = 64;
+	const int nr = n / nt > 2 ? n / nt : 2;
+	complex double *cs = malloc(nr*nt*sizeof(complex double));
+	complex double *ref = malloc(nr*nt*sizeof(complex double));
+	complex double nuclei[nMaxNuclei];
+	char workload[64];
+
+	for (int period = 3; period <= pMax; period++) {
+
+		if (give_nuclei(nuclei, period) == 0) continue;
+		snprintf(workload, sizeof(workload), "grid p = %d", period);
+
+		double t = seconds();
+		int nGridFailed = m_interior_grid(ctx, period, nuclei[0], nr, rMax, nt, cs);
+		t = seconds() - t;
+
+		#pragma omp parallel for schedule(dynamic, 16)
+		for (int k = 0; k < nr*nt; k++) ref[k] = m_interior(ctx, period, nuclei[0], (double) (k / nr)/nt, rMax*(k % nr)/(nr - 1));
+
+		report("m_interior_grid", workload, nr*nt, t, nGridFailed ? INFINITY : max_error(cs, ref, nr*nt), errInterior);
+	}
+
+	free(cs);
+	free(ref);
+}
+
+
+
+int main(int argc, char **argv){
+
+	const int n = argc > 1 ? atoi(argv[1]) : 20000;
+	m_context ctx;
+	m_context_init(&ctx);
+
+	if (n < 1) {
+		fprintf(stderr, "usage: %s [points per workload]\n", argv[0]);
+		return 1;
+	}
+
+	printf (" %-26s %-22s %8s %12s %12s %10s %8s  %s\n", "kernel", "workload", "points", "points/s", "max error", "threshold", "speedup", "result");
+
+	closed_forms(&ctx, n);
+	round_trips(&ctx, n);
+	grids(&ctx, n);
+
+	printf ("\n %d kernels above threshold\n", nFailed);
+	printf (" %d fast variants slower than double\n", nSlow);
+	return nFailed ? 1 : nSlow ? 2 : 0;
+}
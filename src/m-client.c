@@ -0,0 +1,224 @@
+/*
+
+load generator for m-server.c
+
+every thread opens it's own connection to the server and keeps depth requests in flight :
+a new request is sent when a reply comes
+at the end prints client side throughput and latency percentiles and the counters of the server ( request s )
+
+types of requests ( see m-server.c ) :
+* m = multiplier of random c near the period 4 component
+* c = parameter c of the period 4 component for random internal angle and radius
+* p = period of random c ( slow, use small iMax in the server )
+
+
+
+c console program
+
+make m-client
+./m-client [socket path] [threads] [requests per thread] [depth] [types]
+
+./m-server /tmp/multiplier.sock 10000 &
+./m-client /tmp/multiplier.sock 4 100000 32 mc
+
+
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+static const char *path = "/tmp/multiplier.sock";
+static int nThreads = 4;
+static int nRequests = 10000; // per thread
+static int depth = 32; // requests in flight per thread
+static const char *types = "mc";
+
+// period 4 component
+static const int period = 4;
+static const double centerRe = 0.2822713907669138;
+static const double centerIm = 0.5300606175785252;
+
+
+typedef struct {
+	int index;
+	double *latency; // seconds, one for each request
+	int nErrors;
+	bool failed;
+} thread_data;
+
+
+
+static double seconds(void){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+
+static int give_connection(void){
+
+	struct sockaddr_un addr;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) { perror("socket"); return -1; }
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+	if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) { perror("connect"); close(fd); return -1; }
+	return fd;
+}
+
+
+static bool send_all(int fd, const char *s, size_t n){
+
+	while (n > 0) {
+		ssize_t k = write(fd, s, n);
+		if (k <= 0) return false;
+		s += k;
+		n -= k;
+	}
+	return true;
+}
+
+
+/* random request with given id */
+static int give_request(char *s, size_t size, long id, unsigned *seed){
+
+	const int nTypes = strlen(types);
+	const char type = types[rand_r(seed) % nTypes];
+	const double u = (double) rand_r(seed) / RAND_MAX;
+	const double v = (double) rand_r(seed) / RAND_MAX;
+
+	switch (type) {
+		case 'm': return snprintf(s, size, "%ld m %.16f %.16f %d\n", id, centerRe + 0.04*(u - 0.5), centerIm + 0.04*(v - 0.5), period);
+		case 'p': return snprintf(s, size, "%ld p %.16f %.16f\n", id, -0.5 + u, 0.5*v);
+		default: return snprintf(s, size, "%ld c %d %.16f %.16f %.16f %.16f\n", id, period, centerRe, centerIm, u, v);
+	}
+}
+
+
+static void *run(void *arg){
+
+	thread_data *d = arg;
+	unsigned seed = 12345 + d->index;
+	double *sent = malloc(nRequests * sizeof(double));
+	char in[65536];
+	char s[256];
+	int inLen = 0;
+	long nSent = 0, nReceived = 0;
+
+	int fd = give_connection();
+	if (fd < 0) { d->failed = true; free(sent); return NULL; }
+
+	while (nReceived < nRequests) {
+
+		// keep depth requests in flight : send them in one write
+		char out[256*64];
+		int outLen = 0;
+		while (nSent < nRequests && nSent - nReceived < depth && outLen < (int) sizeof(out) - 256) {
+			sent[nSent] = seconds();
+			outLen += give_request(out + outLen, sizeof(out) - outLen, nSent, &seed);
+			nSent++;
+		}
+		if (outLen && ! send_all(fd, out, outLen)) { d->failed = true; break; }
+
+		ssize_t k = read(fd, in + inLen, sizeof(in) - inLen - 1);
+		if (k <= 0) { d->failed = true; break; }
+		inLen += k;
+		const double t = seconds();
+
+		int start = 0;
+		for (int i = 0; i < inLen; i++)
+			if (in[i] == '\n') {
+				in[i] = 0;
+				long id = -1;
+				if (sscanf(in + start, "%ld %255s", &id, s) == 2 && 0 <= id && id < nSent) {
+					d->latency[id] = t - sent[id];
+					if (strcmp(s, "error") == 0) d->nErrors++;
+				}
+				else d->nErrors++;
+				nReceived++;
+				start = i + 1;
+			}
+		memmove(in, in + start, inLen - start);
+		inLen -= start;
+	}
+
+	close(fd);
+	free(sent);
+	return NULL;
+}
+
+
+static int compare(const void *a, const void *b){
+
+	double x = *(const double *) a, y = *(const double *) b;
+	return (x > y) - (x < y);
+}
+
+
+
+int main(int argc, char **argv){
+
+	if (argc > 1) path = argv[1];
+	if (argc > 2) nThreads = atoi(argv[2]);
+	if (argc > 3) nRequests = atoi(argv[3]);
+	if (argc > 4) depth = atoi(argv[4]);
+	if (argc > 5) types = argv[5];
+	if (nThreads < 1 || nRequests < 1 || depth < 1 || strspn(types, "mpc") != strlen(types) || ! *types) {
+		fprintf(stderr, "usage: %s [socket path] [threads] [requests per thread] [depth] [types = m, p, c]\n", argv[0]);
+		return 1;
+	}
+
+	pthread_t *threads = malloc(nThreads * sizeof(pthread_t));
+	thread_data *data = malloc(nThreads * sizeof(thread_data));
+	const long n = (long) nThreads * nRequests;
+	double *latency = calloc(n, sizeof(double));
+	int nErrors = 0;
+
+	double t0 = seconds();
+	for (int i = 0; i < nThreads; i++) {
+		data[i].index = i;
+		data[i].latency = latency + (long) i*nRequests;
+		data[i].nErrors = 0;
+		data[i].failed = false;
+		pthread_create(&threads[i], NULL, run, &data[i]);
+	}
+	for (int i = 0; i < nThreads; i++) {
+		pthread_join(threads[i], NULL);
+		if (data[i].failed) { fprintf(stderr, "thread %d : connection failed\n", i); return 1; }
+		nErrors += data[i].nErrors;
+	}
+	double t1 = seconds();
+
+	qsort(latency, n, sizeof(double), compare);
+
+	printf (" client : %d threads x %d requests, depth = %d, types = %s\n", nThreads, nRequests, depth, types);
+	printf (" throughput = %.1f requests/s \t errors = %d\n", n/(t1 - t0), nErrors);
+	printf (" latency us : p50 = %.0f p90 = %.0f p99 = %.0f p99.9 = %.0f max = %.0f\n",
+		1e6*latency[(long) (0.5*(n-1))], 1e6*latency[(long) (0.9*(n-1))], 1e6*latency[(long) (0.99*(n-1))], 1e6*latency[(long) (0.999*(n-1))], 1e6*latency[n-1]);
+
+	// counters of the server
+	int fd = give_connection();
+	if (fd >= 0) {
+		char s[1024];
+		send_all(fd, "0 s\n", 4);
+		ssize_t k = read(fd, s, sizeof(s) - 1);
+		if (k > 0) { s[k] = 0; printf (" server : %s", s); }
+		close(fd);
+	}
+
+	free(threads);
+	free(data);
+	free(latency);
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+
+find multiplier for given c
+mixed precision version of m.c : float with fallback to double
+
+for
+fc(z) = z^2+c
+
+
+for preview maps and large interior areas of components full double precision Newton is not needed
+here :
+* Newton iteration for the periodic point ( N, give_periodic ) is done in single precision ( float )
+  for a block of pixels at once ( SIMD lanes : float lane is half the size of double lane, so twice as many pixels per vector )
+* a cheap a-posteriori error estimate of the multiplier is computed from the same float numbers
+* only pixels whose result is not trustworthy are recomputed in double ( give_multiplier from m.c ) :
+  - Newton did not converge or result is not finite
+  - periodic point is outside escape radius
+  - not attracting or near neutral : |m| > 1 - ctx.neutral
+    ( for repelling cycles float and double Newton can end in different cycles )
+  - high period : period > ctx.pMaxFloat
+  - estimated error of m is bigger then ctx.tolerance
+* float Newton of a pixel stops when the step is not smaller then the last one ( rounding noise of float ) ,
+  so in small components one pixel does not keep the whole block iterating for nMax steps
+* after the first Newton step the error from rounding c to float alone is estimated ( |dm/dc| * FLT_EPSILON * |c| ) :
+  it does not get smaller with more steps , so pixels with it above ctx.tolerance go to double without iterating in float
+  ( whole block at once if all pixels of the block are such )
+
+so the output precision guarantee ( ctx.tolerance ) is configurable
+
+
+
+error estimate :
+  m = (f^p)'(zp)
+  error of m from error of zp : |(f^p)''(zp)| * |dz|
+  where dz = |f^p(zp) - zp| / |m - 1| = size of the next Newton step ( but not smaller then rounding of zp )
+  plus error from rounding c to float : |dm/dc| * FLT_EPSILON * |c|
+  where dm/dc = dcdz + dzdz*dc/(1 - dz) ( the same derivative as in the interior distance estimate ) ,
+  it is big in small components
+  plus rounding error accumulated in p multiplications : p * FLT_EPSILON * |m|
+  plus rounding of the points of the cycle : m is the product of 2 z_j , so relative error of every z_j goes to m ,
+  z_{j+1} = z_j^2 + c is rounded by about FLT_EPSILON * (|z_j|^2 + |c|) , big relative error when z_{j+1} is near 0
+  ( small |m| ) : |m| * sum of FLT_EPSILON * (|z_j|^2 + |c|) / |z_{j+1}|
+  these are first order terms , the measured error ( m-bench ) is up to 1.25 times their sum ,
+  so the estimate is 2 times the sum
+
+
+
+
+the kernel is m_multiplier_mixed_batch from multiplier library ( multiplier.c ) ,
+this program compares it with double precision m_multiplier ( m.c )
+
+
+
+c console program
+
+make m-mixed
+./m-mixed
+
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <time.h>
+
+#include "multiplier.h"
+
+
+
+static double seconds(void){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+
+// *****************************************************
+
+int main (){
+
+	m_context ctx;
+	m_context_init(&ctx); // mixed precision : tolerance = 1e-4, neutral = 1e-3, pMaxFloat = 64
+
+	// input : window around period 4 component with center = 0.2822713907669138 +0.5300606175785252*I
+	// window crosses the boundary of the component ( main cardioid and exterior of Mandelbrot set ) :
+	// exterior, near neutral and untrustworthy pixels are recomputed in double
+	const int period = 4;
+	const int iWidth = 800;
+	const int iHeight = 800;
+	const complex double cMin = 0.26 + 0.51*I;
+	const complex double cMax = 0.32 + 0.57*I;
+	const int n = iWidth*iHeight;
+
+	complex double *cs = malloc(n*sizeof(complex double));
+	complex double *ms = malloc(n*sizeof(complex double)); // mixed precision
+	complex double *md = malloc(n*sizeof(complex double)); // double
+	int *periods = malloc(n*sizeof(int));
+
+	for (int iy = 0; iy < iHeight; iy++)
+		for (int ix = 0; ix < iWidth; ix++)
+			cs[iy*iWidth + ix] = creal(cMin) + (creal(cMax) - creal(cMin))*ix/iWidth
+				+ I*(cimag(cMin) + (cimag(cMax) - cimag(cMin))*iy/iHeight);
+	for (int k = 0; k < n; k++) periods[k] = period;
+
+	double t0 = seconds();
+	int nDouble = m_multiplier_mixed_batch(&ctx, cs, ms, n, period);
+	double t1 = seconds();
+	m_multiplier_batch(&ctx, cs, periods, md, n);
+	double t2 = seconds();
+
+	// check the guarantee on interior pixels ( |m| < 1 ) = the ones that are used for the multiplier map
+	double maxErr = 0.0;
+	int nInterior = 0;
+	for (int k = 0; k < n; k++)
+		if (cabs(md[k]) < 1.0) {
+			nInterior++;
+			double e = cabs(ms[k] - md[k]);
+			if (e > maxErr) maxErr = e;
+		}
+
+	printf (" period = %d \t window = [%f, %f] x [%f, %f] \t %d x %d pixels\n", period, creal(cMin), creal(cMax), cimag(cMin), cimag(cMax), iWidth, iHeight);
+	printf (" tolerance = %e \t neutral margin = %e \t maximal float period = %d\n", ctx.tolerance, ctx.neutral, ctx.pMaxFloat);
+	printf (" recomputed in double = %d of %d pixels ( %.1f %% )\n", nDouble, n, 100.0*nDouble/n);
+	printf (" interior pixels = %d \t max |m_mixed - m_double| = %e\n", nInterior, maxErr);
+	printf (" time : mixed = %f s \t double = %f s\n", t1-t0, t2-t1);
+
+	free(cs);
+	free(ms);
+	free(md);
+	free(periods);
+	return 0;
+}
@@ -0,0 +1,549 @@
+/*
+
+local query server for multiplier library ( multiplier.h )
+over a Unix domain socket
+
+for
+fc(z) = z^2+c
+
+
+requests and replies are text lines, id is any integer chosen by the client :
+
+  request                                             reply
+  <id> m <c re> <c im> <period>                       <id> <m re> <m im>           multiplier ( give_multiplier from m.c )
+  <id> p <c re> <c im>                                <id> <period>                period ( GivePeriod from p.c )
+  <id> c <period> <center re> <center im> <t> <r>     <id> <c re> <c im>           parameter c from multiplier ( give_c from c.c )
+  <id> s                                              <id> stats ...               counters of the server
+  wrong request                                       <id> error <text>
+
+replies are asynchronous : client can send many requests without waiting, and replies can come in different order
+( use id to match them )
+
+request line longer then IN_SIZE gets one error reply ( id -1 ) and is skipped up to the next newline
+client which does not read it's replies : above OUT_MAX bytes of waiting replies it's requests are not read until it reads
+
+
+threads :
+* input/output thread : accepts clients, reads requests, writes replies ( poll, non-blocking sockets )
+* worker thread : takes all waiting requests as one batch and computes them with the batch kernels of the library ( OpenMP )
+  while the worker computes a batch, new requests are waiting, so under load batches are bigger
+  and with small load a request does not wait for other requests
+
+counters ( request s ) :
+* number of requests and batches, mean batch size
+* throughput = requests per second
+* latency ( from reading the request to queueing the reply ) : mean and percentiles 50, 90, 99, 99.9 from histogram
+
+
+c console program
+
+make m-server
+./m-server [socket path] [iMax for period] [pMax]
+
+default socket path = /tmp/multiplier.sock
+requests m and c with period > pMax ( default 4096 ) get an error reply :
+the cost of one request grows with the period and one huge period would block the worker for all clients
+test with the load generator m-client.c
+
+
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "multiplier.h"
+
+
+#define MAX_CLIENTS 64
+#define IN_SIZE 4096 // maximal length of request line
+#define OUT_MAX (1 << 20) // output backlog of a client : above it the requests of the client are not read until it reads replies
+#define nBuckets 128 // latency histogram : bucket k = [2^(k/4), 2^((k+1)/4)) microseconds
+
+
+
+typedef struct {
+	int slot; // client
+	unsigned gen; // generation of the client slot : reply is dropped if client has gone
+	long id;
+	char type; // m, p, c
+	int period;
+	double a[4]; // arguments
+	double t0; // time of reading
+	// result
+	complex double z;
+	int ip;
+} request;
+
+
+typedef struct {
+	request *r;
+	int n;
+	int cap;
+} request_list;
+
+
+typedef struct {
+	int fd; // -1 = free slot
+	unsigned gen;
+	char in[IN_SIZE];
+	int inLen;
+	bool skipLine; // rest of a too long line is discarded ( up to the next newline )
+	char *out;
+	size_t outLen;
+	size_t outCap;
+} client;
+
+
+
+static m_context ctx;
+static int pMax = 4096; // maximal period of m and c requests
+static client clients[MAX_CLIENTS];
+
+// worker
+static request_list waiting; // requests for the worker
+static request_list done; // results from the worker
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t haveWork = PTHREAD_COND_INITIALIZER;
+static int wakePipe[2]; // worker -> input/output thread : results are done
+
+// counters ( only input/output thread )
+static long nRequests = 0;
+static long nBatches = 0; // counted by worker, read under lock
+static double latencySum = 0.0;
+static long histogram[nBuckets];
+static double tStart;
+
+static volatile sig_atomic_t stop = 0;
+
+
+
+static double seconds(void){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+
+static void push(request_list *l, const request *r){
+
+	if (l->n == l->cap) {
+		l->cap = l->cap ? 2*l->cap : 256;
+		l->r = realloc(l->r, l->cap * sizeof(request));
+	}
+	l->r[l->n++] = *r;
+}
+
+
+
+// ***************************************************************************************
+// worker
+
+
+/* compute one batch : requests of the same type go to one batch kernel */
+static void compute(request *r, int n){
+
+	int nm = 0, np = 0, nc = 0;
+	for (int k = 0; k < n; k++) {
+		if (r[k].type == 'm') nm++;
+		else if (r[k].type == 'p') np++;
+		else if (r[k].type == 'c') nc++;
+	}
+
+	complex double *cs = malloc((n + 1) * sizeof(complex double));
+	complex double *out = malloc((n + 1) * sizeof(complex double));
+	complex double *centers = malloc((n + 1) * sizeof(complex double));
+	int *periods = malloc((n + 1) * sizeof(int));
+	double *angles = malloc((n + 1) * sizeof(double));
+	double *radii = malloc((n + 1) * sizeof(double));
+	int i;
+
+	if (nm) {
+		i = 0;
+		for (int k = 0; k < n; k++) if (r[k].type == 'm') { cs[i] = r[k].a[0] + I*r[k].a[1]; periods[i] = r[k].period; i++; }
+		m_multiplier_batch(&ctx, cs, periods, out, nm);
+		i = 0;
+		for (int k = 0; k < n; k++) if (r[k].type == 'm') r[k].z = out[i++];
+	}
+
+	if (np) {
+		i = 0;
+		for (int k = 0; k < n; k++) if (r[k].type == 'p') cs[i++] = r[k].a[0] + I*r[k].a[1];
+		m_period_batch(&ctx, cs, periods, np);
+		i = 0;
+		for (int k = 0; k < n; k++) if (r[k].type == 'p') r[k].ip = periods[i++];
+	}
+
+	if (nc) {
+		i = 0;
+		for (int k = 0; k < n; k++)
+			if (r[k].type == 'c') {
+				periods[i] = r[k].period;
+				centers[i] = r[k].a[0] + I*r[k].a[1];
+				angles[i] = r[k].a[2];
+				radii[i] = r[k].a[3];
+				i++;
+			}
+		m_interior_batch(&ctx, periods, centers, angles, radii, out, nc);
+		i = 0;
+		for (int k = 0; k < n; k++) if (r[k].type == 'c') r[k].z = out[i++];
+	}
+
+	free(cs);
+	free(out);
+	free(centers);
+	free(periods);
+	free(angles);
+	free(radii);
+}
+
+
+static void *worker(void *arg){
+
+	(void) arg;
+	request_list batch = { NULL, 0, 0 };
+
+	for (;;) {
+		pthread_mutex_lock(&lock);
+		while (waiting.n == 0 && ! stop) pthread_cond_wait(&haveWork, &lock);
+		if (stop) { pthread_mutex_unlock(&lock); break; }
+		// take all waiting requests
+		request_list t = waiting; waiting = batch; batch = t;
+		waiting.n = 0;
+		nBatches++;
+		pthread_mutex_unlock(&lock);
+
+		compute(batch.r, batch.n);
+
+		pthread_mutex_lock(&lock);
+		for (int k = 0; k < batch.n; k++) push(&done, &batch.r[k]);
+		pthread_mutex_unlock(&lock);
+		batch.n = 0;
+
+		char b = 1;
+		if (write(wakePipe[1], &b, 1) < 0 && errno != EAGAIN) perror("write");
+	}
+
+	free(batch.r);
+	return NULL;
+}
+
+
+
+// ***************************************************************************************
+// input/output thread
+
+
+static void append(client *cl, const char *s, int len){
+
+	if (cl->outLen + len > cl->outCap) {
+		cl->outCap = 2*(cl->outLen + len);
+		cl->out = realloc(cl->out, cl->outCap);
+	}
+	memcpy(cl->out + cl->outLen, s, len);
+	cl->outLen += len;
+}
+
+
+static void count_latency(double t0){
+
+	double us = 1e6*(seconds() - t0);
+	int k = us < 1.0 ? 0 : (int) (4.0*log2(us));
+	if (k >= nBuckets) k = nBuckets - 1;
+	histogram[k]++;
+	latencySum += us;
+	nRequests++;
+}
+
+
+/* upper bound of latency percentile q in microseconds */
+static double percentile(double q){
+
+	long total = 0, sum = 0;
+	for (int k = 0; k < nBuckets; k++) total += histogram[k];
+	if (total == 0) return 0.0;
+	for (int k = 0; k < nBuckets; k++) {
+		sum += histogram[k];
+		if (sum >= q*total) return exp2((k + 1)/4.0);
+	}
+	return exp2(nBuckets/4.0);
+}
+
+
+static int give_stats(char *s, size_t size){
+
+	pthread_mutex_lock(&lock);
+	long b = nBatches;
+	pthread_mutex_unlock(&lock);
+	double t = seconds() - tStart;
+
+	return snprintf(s, size, "stats requests = %ld batches = %ld mean batch = %.1f throughput = %.1f /s latency us : mean = %.1f p50 < %.0f p90 < %.0f p99 < %.0f p99.9 < %.0f",
+		nRequests, b, b ? (double) nRequests/b : 0.0, nRequests/t, nRequests ? latencySum/nRequests : 0.0,
+		percentile(0.5), percentile(0.9), percentile(0.99), percentile(0.999));
+}
+
+
+/* parse one request line, computed requests go to the worker, others are answered now */
+static void parse(int slot, char *line, double t0){
+
+	client *cl = &clients[slot];
+	request r;
+	char reply[512];
+	int len;
+	int used = 0;
+
+	memset(&r, 0, sizeof(r));
+	r.slot = slot;
+	r.gen = cl->gen;
+	r.t0 = t0;
+
+	if (sscanf(line, "%ld %c%n", &r.id, &r.type, &used) != 2) {
+		len = snprintf(reply, sizeof(reply), "-1 error can not read id and request type\n");
+		append(cl, reply, len);
+		return;
+	}
+
+	const char *args = line + used;
+	bool ok;
+
+	switch (r.type) {
+		case 'm': ok = sscanf(args, "%lf %lf %d", &r.a[0], &r.a[1], &r.period) == 3 && r.period > 0; break;
+		case 'p': ok = sscanf(args, "%lf %lf", &r.a[0], &r.a[1]) == 2; break;
+		case 'c': ok = sscanf(args, "%d %lf %lf %lf %lf", &r.period, &r.a[0], &r.a[1], &r.a[2], &r.a[3]) == 5 && r.period > 0; break;
+		case 's':
+			len = snprintf(reply, sizeof(reply), "%ld ", r.id);
+			len += give_stats(reply + len, sizeof(reply) - len - 1);
+			reply[len++] = '\n';
+			append(cl, reply, len);
+			return;
+		default: ok = false;
+	}
+
+	if (! ok) {
+		len = snprintf(reply, sizeof(reply), "%ld error wrong request\n", r.id);
+		append(cl, reply, len);
+		return;
+	}
+
+	if (r.period > pMax) {
+		len = snprintf(reply, sizeof(reply), "%ld error period %d > pMax = %d\n", r.id, r.period, pMax);
+		append(cl, reply, len);
+		return;
+	}
+
+	pthread_mutex_lock(&lock);
+	push(&waiting, &r);
+	pthread_cond_signal(&haveWork);
+	pthread_mutex_unlock(&lock);
+}
+
+
+static void read_client(int slot){
+
+	client *cl = &clients[slot];
+	const double t0 = seconds();
+
+	for (;;) {
+		// client which sends but does not read : stop reading it's requests , so it's output does not grow without limit
+		if (cl->outLen >= OUT_MAX) return;
+
+		ssize_t n = read(cl->fd, cl->in + cl->inLen, IN_SIZE - cl->inLen);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+		if (n <= 0) { // closed or error
+			close(cl->fd);
+			cl->fd = -1;
+			cl->gen++;
+			cl->outLen = 0;
+			return;
+		}
+		cl->inLen += n;
+
+		// complete lines
+		int start = 0;
+		for (int i = 0; i < cl->inLen; i++)
+			if (cl->in[i] == '\n') {
+				cl->in[i] = 0;
+				if (cl->skipLine) cl->skipLine = false; // end of too long line
+				else parse(slot, cl->in + start, t0);
+				start = i + 1;
+			}
+		memmove(cl->in, cl->in + start, cl->inLen - start);
+		cl->inLen -= start;
+
+		if (cl->inLen == IN_SIZE) { // too long line : one error reply , then the rest of it is skipped
+			if (! cl->skipLine) {
+				const char *e = "-1 error request line is too long\n";
+				append(cl, e, strlen(e));
+				cl->skipLine = true;
+			}
+			cl->inLen = 0;
+		}
+	}
+}
+
+
+static void write_client(client *cl){
+
+	while (cl->outLen > 0) {
+		ssize_t n = write(cl->fd, cl->out, cl->outLen);
+		if (n < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK) cl->outLen = 0; // broken client, read_client will close it
+			return;
+		}
+		memmove(cl->out, cl->out + n, cl->outLen - n);
+		cl->outLen -= n;
+	}
+}
+
+
+/* results from the worker to the output buffers of clients */
+static void give_replies(void){
+
+	char reply[128];
+	request_list l;
+
+	pthread_mutex_lock(&lock);
+	l = done;
+	done.r = NULL; done.n = 0; done.cap = 0;
+	pthread_mutex_unlock(&lock);
+
+	for (int k = 0; k < l.n; k++) {
+		const request *r = &l.r[k];
+		client *cl = &clients[r->slot];
+		int len;
+
+		if (cl->fd < 0 || cl->gen != r->gen) continue; // client has gone
+
+		if (r->type == 'p') len = snprintf(reply, sizeof(reply), "%ld %d\n", r->id, r->ip);
+		else len = snprintf(reply, sizeof(reply), "%ld %.16e %.16e\n", r->id, creal(r->z), cimag(r->z));
+		append(cl, reply, len);
+		count_latency(r->t0);
+	}
+
+	free(l.r);
+}
+
+
+static void on_signal(int s){
+
+	(void) s;
+	stop = 1;
+}
+
+
+
+int main(int argc, char **argv){
+
+	const char *path = argc > 1 ? argv[1] : "/tmp/multiplier.sock";
+	struct sockaddr_un addr;
+	struct pollfd fds[MAX_CLIENTS + 2];
+	pthread_t workerThread;
+
+	m_context_init(&ctx);
+	if (argc > 2) ctx.iMax = atoi(argv[2]);
+	if (argc > 3) pMax = atoi(argv[3]);
+
+	for (int i = 0; i < MAX_CLIENTS; i++) { clients[i].fd = -1; clients[i].gen = 0; }
+
+	// socket
+	int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (lfd < 0) { perror("socket"); return 1; }
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+	unlink(path);
+	if (bind(lfd, (struct sockaddr *) &addr, sizeof(addr)) < 0) { perror("bind"); return 1; }
+	if (listen(lfd, MAX_CLIENTS) < 0) { perror("listen"); return 1; }
+	fcntl(lfd, F_SETFL, O_NONBLOCK);
+
+	if (pipe2(wakePipe, O_NONBLOCK) < 0) { perror("pipe"); return 1; }
+
+	signal(SIGPIPE, SIG_IGN);
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	tStart = seconds();
+	pthread_create(&workerThread, NULL, worker, NULL);
+	fprintf(stderr, "m-server : listening on %s\n", path);
+
+	while (! stop) {
+
+		int nfds = 0;
+		fds[nfds].fd = lfd; fds[nfds].events = POLLIN; nfds++;
+		fds[nfds].fd = wakePipe[0]; fds[nfds].events = POLLIN; nfds++;
+		for (int i = 0; i < MAX_CLIENTS; i++) {
+			fds[nfds].fd = clients[i].fd; // negative fd is ignored by poll
+			fds[nfds].events = (clients[i].outLen < OUT_MAX ? POLLIN : 0) | (clients[i].outLen ? POLLOUT : 0);
+			nfds++;
+		}
+
+		if (poll(fds, nfds, 1000) < 0) {
+			if (errno == EINTR) continue;
+			perror("poll");
+			break;
+		}
+
+		// new clients
+		if (fds[0].revents & POLLIN) {
+			int cfd;
+			while ((cfd = accept(lfd, NULL, NULL)) >= 0) {
+				int i = 0;
+				while (i < MAX_CLIENTS && clients[i].fd >= 0) i++;
+				if (i == MAX_CLIENTS) { close(cfd); continue; } // too many clients
+				fcntl(cfd, F_SETFL, O_NONBLOCK);
+				clients[i].fd = cfd;
+				clients[i].inLen = 0;
+				clients[i].skipLine = false;
+				clients[i].outLen = 0;
+			}
+		}
+
+		// results
+		if (fds[1].revents & POLLIN) {
+			char b[256];
+			while (read(wakePipe[0], b, sizeof(b)) > 0) ;
+			give_replies();
+		}
+
+		for (int i = 0; i < MAX_CLIENTS; i++) {
+			const short ev = fds[i + 2].revents;
+			if (clients[i].fd < 0 || fds[i + 2].fd != clients[i].fd) continue; // new client, not polled yet
+			if (ev & (POLLIN | POLLHUP | POLLERR)) read_client(i);
+			if (clients[i].fd >= 0) write_client(&clients[i]);
+		}
+	}
+
+	// stop the worker
+	pthread_mutex_lock(&lock);
+	stop = 1;
+	pthread_cond_signal(&haveWork);
+	pthread_mutex_unlock(&lock);
+	pthread_join(workerThread, NULL);
+
+	char s[512];
+	give_stats(s, sizeof(s));
+	fprintf(stderr, "m-server : %s\n", s);
+
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].fd >= 0) close(clients[i].fd);
+		free(clients[i].out);
+	}
+	close(lfd);
+	unlink(path);
+	free(waiting.r);
+	free(done.r);
+	return 0;
+}
@@ -0,0 +1,322 @@
+/*
+
+statistics of period and multiplier over a region of parameter plane
+without images ( streaming reduction, constant memory )
+
+for
+fc(z) = z^2+c
+
+
+for every sample point c ( multiplier library ) :
+* period p = m_period(c) ( p.c )
+* multiplier m = m_multiplier_de(c, p) ( m.c ) , internal radius r = |m| , internal angle t = turn(m)
+* if period was not found ( the critical orbit converges too slowly near neutral cycles ) or the cycle of period p
+  is not attracting or has a smaller exact period : candidate periods from the nearest returns of the critical orbit
+  are tried with m_multiplier_de
+* c is counted as unknown if no attracting cycle with exact period was found
+
+statistics :
+* area per period ( and area of exterior, interior, unknown )
+* histograms of internal radius and internal angle
+* number of neutral and near neutral points : | r - 1 | < neutralEps ( attracting or repelling cycle with exact period )
+* number of unknown points
+
+sampling modes :
+* grid : centers of iWidth x iHeight pixels ( deterministic, no confidence intervals )
+* mc : uniform random points
+* stratified : rounds of nStrata x nStrata cells with one random point in each cell
+  ( confidence intervals of mc are used, they are not smaller then the true ones for stratified sampling )
+
+random modes run in rounds, every thread has it's own accumulator which is merged after the round
+run stops when the 95% confidence interval ( +- 1.96 * standard error ) of the area of interior and of every period
+is smaller then target, or after maxSamples
+
+
+
+c console program
+
+make m-stats
+./m-stats [mode = grid, mc, stratified] [target] [maxSamples] [iMax]
+
+./m-stats stratified 0.002
+
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <complex.h>
+#include <time.h>
+
+#include "multiplier.h"
+
+
+// region
+static const double xMin = -2.0;
+static const double xMax = 0.5;
+static const double yMin = -1.25;
+static const double yMax = 1.25;
+
+// grid mode
+static const int iWidth = 500;
+static const int iHeight = 500;
+
+// random modes
+static const int nStrata = 100; // samples per round = nStrata^2
+
+#define pMaxStats 32 // periods 1 ... pMaxStats, higher periods are counted together
+#define nRadius 10 // bins of internal radius histogram
+#define nAngle 12 // bins of internal angle histogram
+
+static const double neutralEps = 1e-3;
+static const int pMaxCandidate = 1024; // nearest returns of unknown points : periods 1 ... pMaxCandidate
+#define maxCandidates 4 // candidate periods tried with m_multiplier_de
+
+
+
+// accumulator
+typedef struct {
+	long n; // number of samples
+	long exterior;
+	long unknown; // no attracting cycle with exact period found
+	long period[pMaxStats + 2]; // [1 ... pMaxStats] , [pMaxStats + 1] = higher periods
+	long radius[nRadius];
+	long angle[nAngle];
+	long nearNeutral; // | r - 1 | < neutralEps , also when r >= 1 ( counted in unknown then )
+} stats;
+
+
+
+/*
+  candidate periods of c where m_period failed : nearest returns of the critical orbit after iMax iterations
+  q is a candidate if |f^q(w) - w| is smaller then for all smaller q ( periods in ascending order , multiples of the period too )
+  returns the number of candidates , the last maxCandidates of them
+*/
+static int give_candidates(const m_context *ctx, complex double c, int *qs){
+
+	complex double z = 0.0;
+	for (int i = 0; i < ctx->iMax; i++) {
+		z = z*z + c;
+		if (m_cabs2(z) > ctx->er2) return 0;
+	}
+
+	int n = 0;
+	double dMin = INFINITY;
+	complex double w = z;
+	for (int q = 1; q <= pMaxCandidate; q++) {
+		w = w*w + c;
+		const double d = m_cabs2(w - z);
+		if (d < dMin) {
+			dMin = d;
+			if (n == maxCandidates) { memmove(qs, qs + 1, (maxCandidates - 1)*sizeof(int)); n--; }
+			qs[n++] = q;
+		}
+	}
+	return n;
+}
+
+
+/*
+  multiplier of the cycle with exact period of c : m_period , then candidates if that is not an attracting cycle
+  returns the period , 0 = exterior , -1 = no cycle with exact period found
+  *de > 0 : attracting cycle , *de = -1 : no cycle with exact period
+*/
+static int give_cycle(const m_context *ctx, complex double c, complex double *m, double *de){
+
+	// de > 0 only for an attracting cycle with exact period p : near the boundary m_period can give a wrong period
+	// ( c = 0.2655+0.48006i , iMax = 10000 : p = 4 but the period is 1 , the cycle of period 4 has |m| = 1.22 )
+	int p = m_period(ctx, c);
+	if (p == 0) return 0;
+	if (p > 0) {
+		*m = m_multiplier_de(ctx, c, p, de);
+		if (*de > 0.0) return p;
+	}
+
+	// near neutral : critical orbit converges too slowly for m_period ( |r| > 0.996 for iMax = 10000 )
+	int qs[maxCandidates];
+	const int n = give_candidates(ctx, c, qs);
+	int pFound = -1;
+	complex double mFound = 10000;
+	double deFound = -1.0;
+	for (int k = 0; k < n; k++) {
+		double d;
+		const complex double mq = m_multiplier_de(ctx, c, qs[k], &d);
+		if (d == -1.0) continue; // not found or smaller period ( de of a found cycle is near 0 here , never exactly -1 )
+		if (pFound < 0 || d > deFound) { pFound = qs[k]; mFound = mq; deFound = d; }
+		if (d > 0.0) break; // attracting
+	}
+	if (pFound < 0 && p > 0) return p; // cycle of period p from m_period , repelling or not exact
+	*m = mFound;
+	*de = deFound;
+	return pFound;
+}
+
+
+static void add_sample(const m_context *ctx, stats *s, complex double c){
+
+	s->n++;
+	complex double m = 10000;
+	double de = -1.0;
+	const int p = give_cycle(ctx, c, &m, &de);
+	if (p == 0) { s->exterior++; return; }
+
+	const double r = cabs(m);
+	if (de != -1.0 && fabs(r - 1.0) < neutralEps) s->nearNeutral++; // also repelling near neutral cycles
+	if (! (p > 0 && de > 0.0 && r < 1.0)) { s->unknown++; return; } // no attracting cycle with exact period or not finite
+
+	s->period[p <= pMaxStats ? p : pMaxStats + 1]++;
+
+	int k = r * nRadius; // r < 1 so k < nRadius
+	s->radius[k]++;
+	k = m_turn(m) * nAngle;
+	if (k >= nAngle) k = nAngle - 1;
+	s->angle[k]++;
+}
+
+
+static void merge(stats *to, const stats *from){
+
+	to->n += from->n;
+	to->exterior += from->exterior;
+	to->unknown += from->unknown;
+	for (int p = 0; p < pMaxStats + 2; p++) to->period[p] += from->period[p];
+	for (int k = 0; k < nRadius; k++) to->radius[k] += from->radius[k];
+	for (int k = 0; k < nAngle; k++) to->angle[k] += from->angle[k];
+	to->nearNeutral += from->nearNeutral;
+}
+
+
+
+// random numbers : splitmix64 of the sample number , so results do not depend on number of threads
+static double give_random(uint64_t i){
+
+	uint64_t z = i + 0x9e3779b97f4a7c15ULL;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	z = z ^ (z >> 31);
+	return (z >> 11) * 0x1.0p-53; // [0, 1)
+}
+
+
+
+/* half width of 95 % confidence interval of area of k points from n */
+static double give_ci(long k, long n, double area){
+
+	if (n == 0) return INFINITY;
+	double f = (double) k / n;
+	return 1.96 * area * sqrt(f*(1.0 - f)/n);
+}
+
+
+static double max_ci(const stats *s, double area){
+
+	long interior = 0;
+	double ci = 0.0;
+	for (int p = 1; p < pMaxStats + 2; p++) {
+		interior += s->period[p];
+		ci = fmax(ci, give_ci(s->period[p], s->n, area));
+	}
+	return fmax(ci, give_ci(interior, s->n, area));
+}
+
+
+
+static void print_stats(const stats *s, double area, bool random){
+
+	long interior = 0;
+	for (int p = 1; p < pMaxStats + 2; p++) interior += s->period[p];
+
+	printf (" samples = %ld\n", s->n);
+	printf (" area : region = %f\n", area);
+	#define AREA(k) area*(k)/s->n, random ? give_ci(k, s->n, area) : 0.0
+	printf ("\t exterior = %.6f +- %.6f\n", AREA(s->exterior));
+	printf ("\t interior = %.6f +- %.6f\n", AREA(interior));
+	printf ("\t unknown  = %.6f +- %.6f\n", AREA(s->unknown));
+	for (int p = 1; p <= pMaxStats; p++)
+		if (s->period[p]) printf ("\t period %2d = %.6f +- %.6f\n", p, AREA(s->period[p]));
+	if (s->period[pMaxStats + 1]) printf ("\t period > %d = %.6f +- %.6f\n", pMaxStats, AREA(s->period[pMaxStats + 1]));
+	#undef AREA
+
+	printf (" internal radius histogram ( fraction of interior ) :\n");
+	for (int k = 0; k < nRadius; k++)
+		printf ("\t [%.2f, %.2f) %.4f\n", (double) k/nRadius, (double) (k+1)/nRadius, interior ? (double) s->radius[k]/interior : 0.0);
+	printf (" internal angle histogram ( fraction of interior ) :\n");
+	for (int k = 0; k < nAngle; k++)
+		printf ("\t [%.3f, %.3f) %.4f\n", (double) k/nAngle, (double) (k+1)/nAngle, interior ? (double) s->angle[k]/interior : 0.0);
+	printf (" near neutral ( | |m| - 1 | < %g ) = %ld \t unknown ( no attracting cycle found ) = %ld\n", neutralEps, s->nearNeutral, s->unknown);
+}
+
+
+
+static double seconds(void){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+
+
+int main(int argc, char **argv){
+
+	const char *mode = argc > 1 ? argv[1] : "stratified";
+	const double target = argc > 2 ? atof(argv[2]) : 0.005;
+	const long maxSamples = argc > 3 ? atol(argv[3]) : 10000000;
+	m_context ctx;
+	m_context_init(&ctx);
+	ctx.iMax = argc > 4 ? atoi(argv[4]) : 10000; // p.c uses 1000000, too slow for many points
+
+	const bool grid = strcmp(mode, "grid") == 0;
+	const bool stratified = strcmp(mode, "stratified") == 0;
+	if (! grid && ! stratified && strcmp(mode, "mc") != 0) {
+		fprintf(stderr, "usage: %s [mode = grid, mc, stratified] [target] [maxSamples] [iMax]\n", argv[0]);
+		return 1;
+	}
+
+	const double area = (xMax - xMin)*(yMax - yMin);
+	const int nRound = grid ? iWidth*iHeight : nStrata*nStrata; // samples per round
+	stats total;
+	memset(&total, 0, sizeof(total));
+	int round = 0;
+	double ci = INFINITY;
+
+	double t0 = seconds();
+
+	do {
+		#pragma omp parallel
+		{
+			stats s; // accumulator of the thread
+			memset(&s, 0, sizeof(s));
+
+			#pragma omp for schedule(dynamic, 64)
+			for (int i = 0; i < nRound; i++) {
+				double u, v;
+				if (grid) { u = (i % iWidth + 0.5)/iWidth; v = (i / iWidth + 0.5)/iHeight; }
+				else {
+					const uint64_t j = 2*((uint64_t) round*nRound + i);
+					u = give_random(j);
+					v = give_random(j + 1);
+					if (stratified) { u = (i % nStrata + u)/nStrata; v = (i / nStrata + v)/nStrata; }
+				}
+				add_sample(&ctx, &s, xMin + (xMax - xMin)*u + I*(yMin + (yMax - yMin)*v));
+			}
+
+			#pragma omp critical
+			merge(&total, &s);
+		}
+		round++;
+		if (! grid) ci = max_ci(&total, area);
+
+	} while (! grid && ci > target && total.n + nRound <= maxSamples);
+
+	double t1 = seconds();
+
+	printf (" mode = %s \t region = [%g, %g] x [%g, %g] \t iMax = %d\n", mode, xMin, xMax, yMin, yMax, ctx.iMax);
+	if (! grid) printf (" stopped : %s ( max 95%% confidence interval = %f , target = %f ) after %d rounds\n", ci <= target ? "target reached" : "maxSamples", ci, target, round);
+	print_stats(&total, area, ! grid);
+	printf (" time = %f s \t %.0f samples/s\n", t1 - t0, total.n/(t1 - t0));
+	return 0;
+}
@@ -0,0 +1,801 @@
+/*
+
+multiplier library : reentrant kernels of m.c, m-mixed.c, c.c, c-grid.c, m-interior.c and p.c
+see multiplier.h
+
+
+
+parameter c from multiplier uses the code from mandelbrot-numerics library
+ mandelbrot-numerics -- numerical algorithms related to the Mandelbrot set
+ Copyright (C) 2015-2017 Claude Heiland-Allen
+ License GPL3+
+ http://www.gnu.org/licenses/gpl.html
+
+
+
+make
+
+*/
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include <complex.h>
+#include <stdbool.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "multiplier.h"
+
+
+static const double twopi = 6.283185307179586;
+// epsilon^2 of m_d_interior_step
+static const double epsilon2 = 1.9721522630525295e-31;
+
+#define LANES 16 // points in one block of mixed precision Newton
+
+
+
+static inline long double cabs2l(complex long double z) {
+  return creall(z) * creall(z) + cimagl(z) * cimagl(z);
+}
+
+static inline bool cisfinite(complex double z) {
+  return isfinite(creal(z)) && isfinite(cimag(z));
+}
+
+
+
+void m_context_init(m_context *ctx){
+
+	// m.c
+	ctx->eps2 = 1e-16;
+	ctx->er2 = 100.0;
+	ctx->nMax = 64;
+	// multi-start
+	ctx->nSeeds = 8;
+	ctx->nOrbit = 256;
+	// c.c
+	ctx->maxsteps = 100;
+	// p.c
+	ctx->iMax = 1000000;
+	ctx->precision = 1.0E-16;
+	// m-mixed.c
+	ctx->tolerance = 1e-4;
+	ctx->neutral = 1e-3;
+	ctx->pMaxFloat = 64;
+}
+
+
+
+// ***************************************************************************************************************************
+// ************************** PER = Period : p.c *****************************************************************************
+// ***************************************************************************************************************************
+
+
+/*
+  like GivePeriod from p.c but without the orbit array :
+  after iMax iterations the critical orbit is on the attractor,
+  so the period is the first return of the orbit to it's point z
+*/
+int m_period(const m_context *ctx, complex double c){
+
+	const complex long double cl = c;
+	const long double precision2 = ctx->precision * ctx->precision;
+	complex long double z = 0.0; // critical point
+	int i;
+
+	// iteration without saving points
+	for(i=0; i<ctx->iMax; ++i) {
+		z = z*z + cl;
+		if (cabs2l(z) > 4.0) return 0; // escaping = exterior of M set
+	}
+
+	// look for the same point = attractor
+	complex long double w = z;
+	for(i=1; i<=ctx->iMax; ++i) {
+		w = w*w + cl;
+		if (cabs2l(w) > 4.0) return 0;
+		if (cabs2l(w - z) < precision2) {
+			// rounding noise of long double is near the precision in small components :
+			// the first return can be missed and a multiple of the period found ( 16 instead of 8 ) ,
+			// so the smallest divisor q of i which returns almost as close is the period
+			for (int q = 1; q < i; q++) {
+				if (i % q != 0) continue;
+				complex long double v = z;
+				for (int j = 0; j < q; j++) v = v*v + cl;
+				if (cabs2l(v - z) < 4.0 * precision2) return q;
+			}
+			return i; // period
+		}
+	}
+
+	return -1; // period not found , maybe precision is to low
+}
+
+
+
+// ***************************************************************************************************************************
+// ************************** multiplier : m.c *******************************************************************************
+// ***************************************************************************************************************************
+
+
+complex double m_newton_step(complex double c, complex double zn, int period){
+
+	complex double z = zn;
+	complex double d = 1.0; /* d = first derivative with respect to z */
+
+	for (int p=0; p < period; p++){
+		d = 2*z*d; /* first derivative with respect to z */
+		z = z*z +c ; /* complex quadratic polynomial */
+	}
+
+	return zn - (z - zn)/(d - 1);
+}
+
+
+bool m_periodic(const m_context *ctx, complex double c, complex double z0, int period, complex double *zp){
+
+	complex double z = z0;
+	complex double zPrev = z0; // previous value of z
+	bool converged = false;
+
+	for (int n=0; n<ctx->nMax; n++) {
+		z = m_newton_step(c, z, period);
+		if (m_cabs2(z - zPrev) < ctx->eps2) { converged = true; break; }
+		zPrev = z;
+	}
+
+	*zp = z;
+	return converged && m_cabs2(z) < ctx->er2;
+}
+
+
+complex double m_multiplier_at(complex double c, complex double zp, int period){
+
+	complex double z = zp;
+	complex double d = 1.0; // derivative = multiplier
+
+	for (int p=0; p < period; p++){
+		d = 2*z*d; /* first derivative with respect to z */
+		z = z*z +c ; /* complex quadratic polynomial */
+	}
+	return d;
+}
+
+
+int m_exact_period(const m_context *ctx, complex double c, complex double zp, int period){
+
+	complex double z = zp;
+
+	for (int q = 1; q < period; q++) {
+		z = z * z + c;
+		if (period % q == 0 && m_cabs2(z - zp) < ctx->eps2) return q;
+	}
+	return period;
+}
+
+
+static bool is_exact_period(const m_context *ctx, complex double c, complex double zp, int period){
+
+	return m_exact_period(ctx, c, zp, period) == period;
+}
+
+
+bool m_periodic_multistart(const m_context *ctx, complex double c, int period, const complex double *seeds, int nSeeds, complex double *zp, complex double *m){
+
+	complex double z[M_MAX_SEEDS]; // lanes
+	bool active[M_MAX_SEEDS];
+	const int nMaxSeeds = ctx->nSeeds < M_MAX_SEEDS ? ctx->nSeeds : M_MAX_SEEDS;
+	int n = 0;
+	complex double w;
+
+	// caller seeds leave one lane for the late critical orbit : the only seed which is always in the attracting basin
+	for (int k = 0; k < nSeeds && n < nMaxSeeds - 1; k++) z[n++] = seeds[k];
+
+	// late critical orbit
+	// escaping critical orbit : c is outside the Mandelbrot set, there is no attracting cycle
+	w = 0.0;
+	for (int i = 0; i < ctx->nOrbit; i++) {
+		w = w * w + c;
+		if (m_cabs2(w) > 4.0) return false;
+	}
+	if (n < nMaxSeeds) z[n++] = w;
+
+	// critical point and it's images
+	w = 0.0;
+	for (int k = 0; k < period && n < nMaxSeeds && m_cabs2(w) < ctx->er2; k++) { z[n++] = w; w = w * w + c; }
+
+	for (int l = 0; l < n; l++) active[l] = true;
+
+	for (int step = 0; step < ctx->nMax; step++) {
+
+		int nActive = 0;
+
+		for (int l = 0; l < n; l++) {
+			if (! active[l]) continue;
+
+			complex double zNew = m_newton_step(c, z[l], period);
+
+			if (! (m_cabs2(zNew) < ctx->er2)) { active[l] = false; continue; } // diverged or not finite
+			if (m_cabs2(zNew - z[l]) < ctx->eps2) {
+				// converged : attracting cycle with exact period wins , other cycles stop this lane
+				complex double d = m_multiplier_at(c, zNew, period);
+				if (cabs(d) < 1.0 && is_exact_period(ctx, c, zNew, period)) {
+					// lanes can stop with a bigger last step then Newton from the critical point , one more step
+					*zp = m_newton_step(c, zNew, period);
+					*m = m_multiplier_at(c, *zp, period);
+					return true;
+				}
+				active[l] = false;
+				continue;
+			}
+			z[l] = zNew;
+			nActive++;
+		}
+
+		if (nActive == 0) break;
+	}
+
+	return false;
+}
+
+
+/*
+  periodic point for m_multiplier and m_multiplier_de :
+  from the first seed of the caller or else from the critical point like m.c,
+  multi-start ( with all seeds of the caller ) if it did not converge or the cycle is not attracting
+  returns false if no periodic point ( |zp|^2 < er2 ) was found
+*/
+static bool give_periodic(const m_context *ctx, complex double c, int period, const complex double *seeds, int nSeeds, complex double *zp){
+
+	complex double m;
+	bool converged = m_periodic(ctx, c, nSeeds > 0 ? seeds[0] : 0.0, period, zp);
+
+	if (converged && cabs(m_multiplier_at(c, *zp, period)) < 1.0) return true;
+	if (ctx->nSeeds > 0 && m_periodic_multistart(ctx, c, period, seeds, nSeeds, zp, &m)) return true;
+
+	// zp is still the last point of Newton from the first seed :
+	// m.c uses it also if Newton did not converge in nMax steps
+	return m_cabs2(*zp) < ctx->er2;
+}
+
+
+complex double m_multiplier_seeded(const m_context *ctx, complex double c, int period, const complex double *seeds, int nSeeds){
+
+	complex double zp; // periodic point
+
+	switch(period){
+		case 1  : return 1.0 - csqrt(1.0-4.0*c); // explicit
+		case 2  : return 4.0*c + 4; // explicit
+		default :
+			// numerical approximation
+			if (give_periodic(ctx, c, period, seeds, nSeeds, &zp)) return m_multiplier_at(c, zp, period);
+			return 10000;
+	}
+}
+
+
+complex double m_multiplier(const m_context *ctx, complex double c, int period){
+
+	return m_multiplier_seeded(ctx, c, period, NULL, 0);
+}
+
+
+complex double m_multiplier_de(const m_context *ctx, complex double c, int period, double *de){
+
+	complex double zp; // periodic point
+
+	switch(period){
+		case 1  : zp = (1.0 - csqrt(1.0-4.0*c))/2.0; break; // explicit : attracting fixed point
+		case 2  : zp = (-1.0 + csqrt(-3.0-4.0*c))/2.0; break; // explicit
+		default :
+			if (! give_periodic(ctx, c, period, NULL, 0, &zp)) { if (de) *de = -1; return 10000; }
+	}
+
+	// the same derivatives as in m_d_interior_step
+	complex double z = zp;
+	complex double dz = 1;
+	complex double dc = 0;
+	complex double dzdz = 0;
+	complex double dcdz = 0;
+	for (int p = 0; p < period; ++p) {
+		dcdz = 2 * (z * dcdz + dc * dz);
+		dzdz = 2 * (z * dzdz + dz * dz);
+		dc = 2 * z * dc + 1;
+		dz = 2 * z * dz;
+		z = z * z + c;
+	}
+
+	if (de) {
+		*de = (1 - m_cabs2(dz)) / cabs(dcdz + dzdz * dc / (1 - dz));
+		// Newton found a cycle with smaller period q which divides period : c is in other component
+		if (! is_exact_period(ctx, c, zp, period)) *de = -1;
+	}
+	return dz;
+}
+
+
+double m_turn(complex double z){
+
+	double t = carg(z) / twopi; // now in turns
+	if (t<0.0) t += 1.0; // map from (-1/2,1/2] to [0, 1)
+	return t;
+}
+
+
+
+// ***************************************************************************************************************************
+// ************************** parameter c from multiplier : c.c **************************************************************
+// ***************************************************************************************************************************
+
+
+// mandelbrot-numerics/c/lib/m_d_interior.c
+m_newton m_d_interior_step(complex double *z_out, complex double *c_out, complex double z_guess, complex double c_guess, complex double multiplier, int period) {
+  complex double c = c_guess;
+  complex double z = z_guess;
+  complex double dz = 1;
+  complex double dc = 0;
+  complex double dzdz = 0;
+  complex double dcdz = 0;
+  for (int p = 0; p < period; ++p) {
+    dcdz = 2 * (z * dcdz + dc * dz);
+    dzdz = 2 * (z * dzdz + dz * dz);
+    dc = 2 * z * dc + 1;
+    dz = 2 * z * dz;
+    z = z * z + c;
+  }
+  complex double det = (dz - 1) * dcdz - dc * dzdz;
+  complex double z_new = z_guess - (dcdz * (z - z_guess) - dc * (dz - multiplier)) / det;
+  complex double c_new = c_guess - ((dz - 1) * (dz - multiplier) - dzdz * (z - z_guess)) / det;
+  if (cisfinite(z_new) && cisfinite(c_new)) {
+    *z_out = z_new;
+    *c_out = c_new;
+    if (m_cabs2(z_new - z_guess) <= epsilon2 && m_cabs2(c_new - c_guess) <= epsilon2) {
+      return m_converged;
+    } else {
+      return m_stepped;
+    }
+  } else {
+    *z_out = z_guess;
+    *c_out = c_guess;
+    return m_failed;
+  }
+}
+
+
+m_newton m_d_interior(complex double *z_out, complex double *c_out, complex double z_guess, complex double c_guess, complex double multiplier, int period, int maxsteps) {
+
+	m_newton result = m_failed;
+	complex double z = z_guess;
+	complex double c = c_guess;
+
+	for (int i = 0; i < maxsteps; ++i) {
+		if (m_stepped != (result = m_d_interior_step(&z, &c, z, c, multiplier, period)))
+			{ break; }
+	}
+	*z_out = z;
+	*c_out = c;
+
+	// loop was not left by break = no failure, see c.c
+	if (result == m_stepped) return m_converged;
+
+	return result;
+}
+
+
+complex double m_interior(const m_context *ctx, int period, complex double center, double angle, double radius){
+
+	const complex double m = radius * cexp(I*twopi*angle); // multiplier
+	complex double z, c;
+
+	// map circle to component
+	switch (period){
+		case 1: return (2.0*m - m*m)/4.0;
+		case 2: return (m - 4.0)/4.0;
+		default :
+			// for higher periods there is no exact method; use numerical aproximation
+			if (m_converged != m_d_interior(&z, &c, 0.0, center, m, period, ctx->maxsteps)) return -1000;
+			return c;
+	}
+}
+
+
+
+// ***************************************************************************************************************************
+// ************************** batch ******************************************************************************************
+// ***************************************************************************************************************************
+
+
+void m_period_batch(const m_context *ctx, const complex double *cs, int *periods, int n){
+
+	#pragma omp parallel for schedule(dynamic, 16)
+	for (int k = 0; k < n; k++) periods[k] = m_period(ctx, cs[k]);
+}
+
+
+void m_multiplier_batch(const m_context *ctx, const complex double *cs, const int *periods, complex double *ms, int n){
+
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int k = 0; k < n; k++) ms[k] = m_multiplier(ctx, cs[k], periods[k]);
+}
+
+
+void m_multiplier_seeded_batch(const m_context *ctx, const complex double *cs, const int *periods, const complex double *seeds, int nSeeds, complex double *ms, int n){
+
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int k = 0; k < n; k++) ms[k] = m_multiplier_seeded(ctx, cs[k], periods[k], seeds + (size_t) k*nSeeds, nSeeds);
+}
+
+
+void m_multiplier_de_batch(const m_context *ctx, const complex double *cs, const int *periods, complex double *ms, double *des, int n){
+
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int k = 0; k < n; k++) ms[k] = m_multiplier_de(ctx, cs[k], periods[k], des ? &des[k] : NULL);
+}
+
+
+void m_interior_batch(const m_context *ctx, const int *periods, const complex double *centers, const double *angles, const double *radii, complex double *cs, int n){
+
+	#pragma omp parallel for schedule(dynamic, 16)
+	for (int k = 0; k < n; k++) cs[k] = m_interior(ctx, periods[k], centers[k], angles[k], radii[k]);
+}
+
+
+
+// ************************** mixed precision : m-mixed.c **************************
+// complex numbers are split into real and imaginary float arrays, so the loops over lanes can be vectorised
+
+
+/*
+  Newton iteration for periodic points of LANES points at once, from zr, zi
+  a lane stops ( done ) when the step is smaller then eps2 or when it is not smaller then the last step :
+  in small components float rounding noise is bigger then eps2 , so one stuck lane would run the block for all nMax steps
+  ( the error estimate then sends it to double )
+  last2 = square of the last step , done lanes are not moved
+*/
+static void periodic_f(const float *cr, const float *ci, const int period, const int nMax, const float eps2, float *zr, float *zi, float *last2, int *done){
+
+	for (int n = 0; n < nMax; n++) {
+
+		int nMoving = 0;
+
+		#pragma omp simd reduction(+:nMoving)
+		for (int l = 0; l < LANES; l++) {
+
+			const float x0 = zr[l];
+			const float y0 = zi[l];
+			float x = x0, y = y0; // z
+			float dx = 1.0f, dy = 0.0f; // d = first derivative with respect to z
+
+			for (int p = 0; p < period; p++) {
+				const float t = 2.0f*(x*dx - y*dy);
+				dy = 2.0f*(x*dy + y*dx);
+				dx = t;
+				const float u = x*x - y*y + cr[l];
+				y = 2.0f*x*y + ci[l];
+				x = u;
+			}
+
+			// N(z) = z - (fp(z)-z)/(f'(z) - 1)
+			const float fx = x - x0, fy = y - y0;
+			const float gx = dx - 1.0f, gy = dy;
+			const float den = gx*gx + gy*gy;
+			const float qx = (fx*gx + fy*gy)/den;
+			const float qy = (fy*gx - fx*gy)/den;
+			const float step2 = qx*qx + qy*qy;
+
+			if (! done[l]) {
+				zr[l] = x0 - qx;
+				zi[l] = y0 - qy;
+				done[l] = step2 < eps2 || ! (step2 < last2[l]); // NaN is done , estimate is NaN then
+				last2[l] = step2;
+			}
+			nMoving += ! done[l];
+		}
+
+		if (nMoving == 0) break;
+	}
+}
+
+
+/*
+  first Newton step from the critical point for LANES points , like periodic_f ,
+  and errC2 = square of error of m from rounding c to float , the same term as in multiplier_f but with the derivatives at 0
+  ( periodic point of the nucleus ) , so in the same loop :
+  it does not get smaller with better zp , so lanes with errC2 above tolerance^2 need not be iterated
+  ( it is only an estimate for the choice , multiplier_f decides if the result is trusted ) , no sqrtf : the loop is vectorised
+*/
+static void first_step_f(const float *cr, const float *ci, const int period, float *zr, float *zi, float *last2, float *errC2){
+
+	#pragma omp simd
+	for (int l = 0; l < LANES; l++) {
+
+		float x = 0.0f, y = 0.0f;
+		float dx = 1.0f, dy = 0.0f, ddx = 0.0f, ddy = 0.0f, cx = 0.0f, cy = 0.0f, dcx = 0.0f, dcy = 0.0f;
+
+		for (int p = 0; p < period; p++) {
+			const float v = 2.0f*(x*dcx - y*dcy + cx*dx - cy*dy);
+			dcy = 2.0f*(x*dcy + y*dcx + cx*dy + cy*dx);
+			dcx = v;
+			const float w = 2.0f*(x*cx - y*cy) + 1.0f;
+			cy = 2.0f*(x*cy + y*cx);
+			cx = w;
+			const float t = 2.0f*(x*ddx - y*ddy + dx*dx - dy*dy);
+			ddy = 2.0f*(x*ddy + y*ddx + 2.0f*dx*dy);
+			ddx = t;
+			const float s = 2.0f*(x*dx - y*dy);
+			dy = 2.0f*(x*dy + y*dx);
+			dx = s;
+			const float u = x*x - y*y + cr[l];
+			y = 2.0f*x*y + ci[l];
+			x = u;
+		}
+
+		// N(0) = 0 - (f^p(0) - 0)/(d - 1) , d = 0 at the critical point
+		zr[l] = x;
+		zi[l] = y;
+		last2[l] = x*x + y*y;
+
+		// dm/dc = dcdz + dzdz*dc/(1 - dz)
+		const float gx = dx - 1.0f, gy = dy;
+		const float den = gx*gx + gy*gy;
+		const float qx = -(cx*gx + cy*gy)/den, qy = -(cy*gx - cx*gy)/den;
+		const float mcx = dcx + ddx*qx - ddy*qy, mcy = dcy + ddx*qy + ddy*qx;
+		errC2[l] = 4.0f * (mcx*mcx + mcy*mcy) * FLT_EPSILON * FLT_EPSILON * (cr[l]*cr[l] + ci[l]*ci[l]);
+	}
+}
+
+
+/* multiplier and it's estimated error for LANES periodic points ( float ) , see m-mixed.c */
+static void multiplier_f(const float *cr, const float *ci, const float *zr, const float *zi, const int period, const float er2, float *mr, float *mi, float *err){
+
+	#pragma omp simd
+	for (int l = 0; l < LANES; l++) {
+
+		float x = zr[l], y = zi[l];
+		float dx = 1.0f, dy = 0.0f; // first derivative with respect to z
+		float ddx = 0.0f, ddy = 0.0f; // second derivative with respect to z
+		float cx = 0.0f, cy = 0.0f; // first derivative with respect to c
+		float dcx = 0.0f, dcy = 0.0f; // derivative of d with respect to c
+		float orbit = 0.0f; // sum of ( rounding of z_{j+1} / |z_{j+1}| )^2 / FLT_EPSILON^2
+		const float zabs2 = x*x + y*y;
+		const float cabs1 = sqrtf(cr[l]*cr[l] + ci[l]*ci[l]);
+
+		for (int p = 0; p < period; p++) {
+			const float v = 2.0f*(x*dcx - y*dcy + cx*dx - cy*dy);
+			dcy = 2.0f*(x*dcy + y*dcx + cx*dy + cy*dx);
+			dcx = v;
+			const float w = 2.0f*(x*cx - y*cy) + 1.0f;
+			cy = 2.0f*(x*cy + y*cx);
+			cx = w;
+			const float t = 2.0f*(x*ddx - y*ddy + dx*dx - dy*dy);
+			ddy = 2.0f*(x*ddy + y*ddx + 2.0f*dx*dy);
+			ddx = t;
+			const float s = 2.0f*(x*dx - y*dy);
+			dy = 2.0f*(x*dy + y*dx);
+			dx = s;
+			const float r = x*x + y*y + cabs1; // z_{j+1} = z_j^2 + c is rounded by about FLT_EPSILON*r
+			const float u = x*x - y*y + cr[l];
+			y = 2.0f*x*y + ci[l];
+			x = u;
+			orbit += r*r / (x*x + y*y);
+		}
+
+		// size of the next Newton step = error of periodic point
+		const float fx = x - zr[l], fy = y - zi[l];
+		const float gx = dx - 1.0f, gy = dy;
+		float dz = sqrtf((fx*fx + fy*fy)/(gx*gx + gy*gy));
+		const float dzRound = FLT_EPSILON * sqrtf(zabs2); // rounding of zp itself
+		if (dz < dzRound) dz = dzRound;
+
+		// dm/dc = dcdz + dzdz*dc/(1 - dz) ( like the interior distance estimate ) : c is rounded to float
+		const float den = gx*gx + gy*gy;
+		const float qx = -(cx*gx + cy*gy)/den, qy = -(cy*gx - cx*gy)/den;
+		const float mcx = dcx + ddx*qx - ddy*qy, mcy = dcy + ddx*qy + ddy*qx;
+		const float dc = FLT_EPSILON * cabs1;
+
+		// m = product of 2 z_j : relative rounding of every z_j goes to m ,
+		// sum of it is not bigger then sqrt(period * orbit) ( Cauchy-Schwarz , no sqrt in the loop ) ,
+		// and every complex multiplication of the derivative adds about FLT_EPSILON
+		const float mabs = sqrtf(dx*dx + dy*dy);
+		const float relative = FLT_EPSILON * (sqrtf(period * orbit) + period);
+		// first order terms , rounding errors of z_j also move the other points of the cycle : safety factor 2
+		// ( the measured error is up to 1.25 times the sum of the terms , m-bench )
+		float e = 2.0f * (sqrtf(ddx*ddx + ddy*ddy) * dz + sqrtf(mcx*mcx + mcy*mcy) * dc + relative * mabs);
+		if (! (zabs2 < er2)) e = INFINITY;
+
+		mr[l] = dx;
+		mi[l] = dy;
+		err[l] = e;
+	}
+}
+
+
+int m_multiplier_mixed_batch(const m_context *ctx, const complex double *cs, complex double *ms, int n, int period){
+
+	const float eps2 = 1e-10f; // float has ~ 7 decimal digits so smaller steps are only rounding noise
+	const float tolerance2 = ctx->tolerance * ctx->tolerance;
+	int nDouble = 0;
+
+	// explicit formulas are cheap in double
+	// high periods : too much rounding in float
+	if (period <= 2 || period > ctx->pMaxFloat) {
+		#pragma omp parallel for schedule(dynamic, 64)
+		for (int k = 0; k < n; k++) ms[k] = m_multiplier(ctx, cs[k], period);
+		return period <= 2 ? 0 : n;
+	}
+
+	const int nBlocks = (n + LANES - 1) / LANES;
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:nDouble)
+	for (int b = 0; b < nBlocks; b++) {
+
+		float cr[LANES], ci[LANES], zr[LANES], zi[LANES];
+		float mr[LANES], mi[LANES], err[LANES], errC2[LANES];
+		const int k0 = b * LANES;
+		const int kn = (n - k0 < LANES) ? n - k0 : LANES;
+
+		for (int l = 0; l < LANES; l++) {
+			// last block : fill unused lanes with a copy of the first point
+			const complex double c = cs[k0 + (l < kn ? l : 0)];
+			cr[l] = creal(c);
+			ci[l] = cimag(c);
+		}
+
+		float last2[LANES];
+		int done[LANES];
+
+		// first Newton step , then rounding of c alone : if it is above tolerance float can not be trusted for any zp
+		// ( small components ) , such lanes are not iterated and a block of such lanes goes to double at once
+		first_step_f(cr, ci, period, zr, zi, last2, errC2);
+		int nHopeless = 0;
+		for (int l = 0; l < LANES; l++) { done[l] = errC2[l] > tolerance2; nHopeless += done[l]; }
+
+		if (nHopeless == LANES) {
+			for (int l = 0; l < kn; l++) ms[k0 + l] = m_multiplier(ctx, cs[k0 + l], period);
+			nDouble += kn;
+			continue;
+		}
+
+		periodic_f(cr, ci, period, ctx->nMax - 1, eps2, zr, zi, last2, done);
+		multiplier_f(cr, ci, zr, zi, period, ctx->er2, mr, mi, err);
+
+		for (int l = 0; l < kn; l++) {
+
+			const double mabs = sqrt((double) mr[l]*mr[l] + (double) mi[l]*mi[l]);
+			const bool trusted = err[l] <= ctx->tolerance // false for NaN
+				&& mabs <= 1.0 - ctx->neutral;
+
+			if (trusted)
+				{ ms[k0 + l] = mr[l] + I*mi[l]; }
+				else { ms[k0 + l] = m_multiplier(ctx, cs[k0 + l], period); nDouble++; }
+		}
+	}
+
+	return nDouble;
+}
+
+
+
+// ************************** polar grid : c-grid.c **************************
+
+
+/* one grid node : seeds in order, then the nucleus ( like m_interior ) */
+static bool solve_node(const m_context *ctx, complex double *z_out, complex double *c_out, const int p, const complex double center, const complex double m, const complex double *z_seeds, const complex double *c_seeds, const int nSeeds){
+
+	complex double z;
+	complex double c;
+
+	for (int s = 0; s < nSeeds; s++){
+		if (m_converged == m_d_interior(&z, &c, z_seeds[s], c_seeds[s], m, p, ctx->maxsteps) )
+			{ *z_out = z; *c_out = c; return true; }
+	}
+
+	if (m_converged == m_d_interior(&z, &c, 0.0, center, m, p, ctx->maxsteps) )
+		{ *z_out = z; *c_out = c; return true; }
+
+	*z_out = 0.0;
+	*c_out = -1000;
+	return false;
+}
+
+
+int m_interior_grid(const m_context *ctx, int period, complex double center, int nr, double rMax, int nt, complex double *cs){
+
+	const int p = period;
+	int nFailed = 0;
+
+	if (nr < 2 || nt < 1) return -1;
+
+	const double dr = rMax / (nr - 1); // radial step
+
+	// map circle to component : exact methods
+	if (p == 1 || p == 2) {
+		#pragma omp parallel for schedule(static)
+		for (int j = 0; j < nt; j++)
+			for (int i = 0; i < nr; i++){
+				complex double m = dr*i * cexp(I*twopi*j/nt);
+				cs[j*nr + i] = (p == 1) ? (2.0*m - m*m)/4.0 : (m - 4.0)/4.0;
+			}
+		return 0;
+	}
+
+	// nucleus is the same node ( r = 0 ) for all rays
+	complex double z0 ;
+	complex double c0 ;
+	if (! solve_node(ctx, &z0, &c0, p, center, 0.0, NULL, NULL, 0)) {
+		for (int k = 0; k < nr*nt; k++) cs[k] = -1000;
+		return nr*nt;
+	}
+
+	// angular blocks of rays : inside the block ray j is seeded from ray j-1
+	// blocks are independent and run in parallel
+	int nBlocks = nt;
+	const int minRaysPerBlock = 4;
+	#ifdef _OPENMP
+	nBlocks = omp_get_max_threads() * 4; // a few blocks per thread for load balance
+	#endif
+	if (nBlocks > nt / minRaysPerBlock) nBlocks = nt / minRaysPerBlock;
+	if (nBlocks < 1) nBlocks = 1;
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:nFailed)
+	for (int b = 0; b < nBlocks; b++) {
+
+		const int jStart = (b * nt) / nBlocks;
+		const int jEnd = ((b + 1) * nt) / nBlocks;
+		// z of the previous ray ( c of the previous ray is already in cs )
+		complex double *zs = malloc(nr * sizeof(complex double));
+		// node i of the previous ray was found : failed nodes ( c = -1000 ) are not used as seeds
+		bool *found = malloc(nr * sizeof(bool));
+		bool havePrevRay = false;
+
+		for (int j = jStart; j < jEnd; j++) {
+
+			const complex double u = cexp(I*twopi*j/nt); // unit multiplier
+			const double dt = 2.0*sin(twopi/2/nt); // angular step on the unit circle : |u_j - u_{j-1}|
+			complex double *cRay = cs + j*nr;
+			complex double zPrev = z0; // previous radius on this ray
+			complex double cPrev = c0;
+
+			cRay[0] = c0;
+
+			for (int i = 1; i < nr; i++) {
+
+				const double r = dr*i;
+				complex double z_seeds[2];
+				complex double c_seeds[2];
+				int nSeeds = 0;
+				complex double z;
+				complex double c;
+
+				const bool angular = havePrevRay && found[i];
+
+				// radial neighbour is at distance dr, angular neighbour at r*dt
+				if (angular && r*dt < dr) {
+					z_seeds[nSeeds] = zs[i]; c_seeds[nSeeds] = cs[(j-1)*nr + i]; nSeeds++;
+					z_seeds[nSeeds] = zPrev; c_seeds[nSeeds] = cPrev; nSeeds++;
+				}
+				else {
+					z_seeds[nSeeds] = zPrev; c_seeds[nSeeds] = cPrev; nSeeds++;
+					if (angular) {z_seeds[nSeeds] = zs[i]; c_seeds[nSeeds] = cs[(j-1)*nr + i]; nSeeds++;}
+				}
+
+				found[i] = solve_node(ctx, &z, &c, p, center, r*u, z_seeds, c_seeds, nSeeds);
+				if (! found[i])
+					{ nFailed++; z = zPrev; } // keep the previous z as a seed for the next radius
+				else { cPrev = c; }
+
+				zs[i] = z;
+				zPrev = z;
+				cRay[i] = c;
+			}
+			havePrevRay = true;
+		}
+
+		free(zs);
+		free(found);
+	}
+
+	return nFailed;
+}
@@ -0,0 +1,219 @@
+/*
+
+multiplier library : reentrant kernels of m.c, m-mixed.c, c.c, c-grid.c, m-interior.c and p.c
+( c-grid.c, m-mixed.c and m-anim.c use the library , m.c, c.c, m-interior.c and p.c are standalone references )
+
+for
+fc(z) = z^2+c
+
+* no global state : all algorithm parameters are in m_context, which is given by the caller
+  and only read by the library, so one context can be shared by many threads
+* every function can be called from many threads at once
+* batch functions ( *_batch, m_interior_grid ) use OpenMP threads if the library was compiled with -fopenmp
+
+
+
+make
+gcc your-program.c -Wall -L. -lmultiplier -lm -fopenmp
+g++ your-program.cpp -Wall -L. -lmultiplier -lm -fopenmp
+
+*/
+#ifndef MULTIPLIER_H
+#define MULTIPLIER_H
+
+#include <stdbool.h>
+
+// complex numbers : complex double of C99 , std::complex<double> for C++ callers
+// ( both are two doubles, real and imaginary part , the same layout and calling convention )
+#ifdef __cplusplus
+#include <complex>
+typedef std::complex<double> m_complex;
+#else
+#include <complex.h>
+typedef complex double m_complex;
+#endif
+
+// |z|^2 = cnorm = fast cabs , no sqrt : for comparisons with er2 and eps2 , inline so callers can use it in inner loops
+#ifdef __cplusplus
+static inline double m_cabs2(m_complex z) { return std::norm(z); }
+#else
+static inline double m_cabs2(m_complex z) { return creal(z) * creal(z) + cimag(z) * cimag(z); }
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+// mandelbrot-numerics/c/include/mandelbrot-numerics.h
+enum m_newton { m_failed, m_stepped, m_converged };
+typedef enum m_newton m_newton;
+
+
+
+#define M_MAX_SEEDS 32
+
+
+
+typedef struct {
+
+	// periodic point and multiplier : m.c
+	double eps2; // Newton : stop when |z_{n+1} - z_n|^2 < eps2
+	double er2; // bailout = ER2 = (EscapeRadius)^2
+	int nMax; // maximal number of Newton steps for periodic point
+
+	// multi-start periodic point : m_periodic_multistart
+	int nSeeds; // maximal number of seeds ( <= M_MAX_SEEDS ), 0 = only the critical point like m.c
+	int nOrbit; // iterations of critical orbit for the late orbit seed
+
+	// interior coordinates : c.c
+	int maxsteps; // maximal number of Newton steps for c
+
+	// period : p.c
+	int iMax; // number of iterations of critical orbit before period detection , and the maximal period
+	long double precision; // two points of orbit are the same if |z1 - z2| < precision
+
+	// mixed precision : m-mixed.c
+	double tolerance; // maximal accepted estimated error of multiplier
+	double neutral; // recompute in double if |m| > 1 - neutral
+	int pMaxFloat; // recompute in double if period > pMaxFloat
+
+} m_context;
+
+
+// values used by m.c, c.c, p.c and m-mixed.c
+void m_context_init(m_context *ctx);
+
+
+
+// ************************ period : p.c **************************
+
+/*
+  period of the attracting cycle of the critical orbit ( the first return closer then precision ,
+  reduced to it's smallest divisor which returns closer then 2*precision : rounding noise can hide the first return )
+  returns
+  0 = exterior ( escaping critical orbit )
+  -1 = period not found ( maybe precision is to low or c is on the boundary )
+*/
+int m_period(const m_context *ctx, m_complex c);
+
+
+
+// ************************ multiplier : m.c **************************
+
+/* newton function : N(z) = z - (fp(z)-z)/f'(z)) */
+m_complex m_newton_step(m_complex c, m_complex zn, int period);
+
+/*
+  periodic point zp : f^period(zp) = zp , Newton method from the seed z0
+  returns true if Newton converged and |zp|^2 < er2
+*/
+bool m_periodic(const m_context *ctx, m_complex c, m_complex z0, int period, m_complex *zp);
+
+/*
+  periodic point of the attracting cycle with multi-start Newton
+  all seeds make Newton steps together ( one step for every seed in a round , at most nMax rounds ) ,
+  the first seed which converges to an attracting cycle ( |m| < 1 ) with exactly this period wins and the others are stopped
+  seeds in order :
+  * seeds given by the caller ( previous neighbours, points of the nucleus cycle ... ) , can be NULL ,
+    at most nSeeds - 1 of them ( of the context ) , so there is always a lane for the late critical orbit
+  * late point of the critical orbit f^nOrbit(0) : attracting cycle always attracts the critical orbit
+    ( so if the critical orbit escapes there is no attracting cycle and no Newton is done )
+  * critical point 0 and it's images f^k(0), k < period
+  returns true if found, then zp = periodic point and m = multiplier
+*/
+bool m_periodic_multistart(const m_context *ctx, m_complex c, int period, const m_complex *seeds, int nSeeds, m_complex *zp, m_complex *m);
+
+/*
+  smallest period of periodic point zp : the smallest q which divides period with f^q(zp) = zp
+  ( periodic point of period q is also periodic with period )
+*/
+int m_exact_period(const m_context *ctx, m_complex c, m_complex zp, int period);
+
+/* multiplier = first derivative of f^period at periodic point zp */
+m_complex m_multiplier_at(m_complex c, m_complex zp, int period);
+
+/*
+  multiplier of the periodic orbit with given period ( give_multiplier from m.c )
+  explicit for periods 1 and 2, numerical approximation for higher periods :
+  Newton from the critical point like m.c, if it fails or ends in a repelling cycle then m_periodic_multistart
+  returns 10000 if the periodic point was not found
+*/
+m_complex m_multiplier(const m_context *ctx, m_complex c, int period);
+
+/*
+  m_multiplier with seeds of the caller ( previous neighbours, points of a known cycle ... ) :
+  Newton from seeds[0] instead of the critical point , multi-start with all nSeeds seeds if that is not an attracting cycle
+*/
+m_complex m_multiplier_seeded(const m_context *ctx, m_complex c, int period, const m_complex *seeds, int nSeeds);
+
+/*
+  multiplier and interior distance estimate de
+  de = (1 - |dz|^2) / |dcdz + dzdz*dc/(1 - dz)|  with the derivatives of f^period at periodic point ( like in m_d_interior_step )
+  the disk with center c and radius de/4 is inside the Mandelbrot set ( so also inside the component )
+  de < 0 : c is not inside the component ( |m| > 1 ) ,
+  de = -1 if the periodic point was not found ( m = 10000 ) or it's period is smaller ( c is in other component )
+  de can be NULL
+*/
+m_complex m_multiplier_de(const m_context *ctx, m_complex c, int period, double *de);
+
+/* argument in turns [0, 1) of complex number z ( internal angle of multiplier ) */
+double m_turn(m_complex z);
+
+
+
+// ************************ parameter c from multiplier : c.c **************************
+
+// mandelbrot-numerics/c/lib/m_d_interior.c
+m_newton m_d_interior_step(m_complex *z_out, m_complex *c_out, m_complex z_guess, m_complex c_guess, m_complex multiplier, int period);
+// with the changed return policy from c.c : all maxsteps steps without failure = m_converged
+m_newton m_d_interior(m_complex *z_out, m_complex *c_out, m_complex z_guess, m_complex c_guess, m_complex multiplier, int period, int maxsteps);
+
+/*
+  parameter c of the component with given period and nucleus center for multiplier m = radius*e^(2*pi*i*angle)
+  angle in turns ( give_c from c.c )
+  returns -1000 if Newton failed
+*/
+m_complex m_interior(const m_context *ctx, int period, m_complex center, double angle, double radius);
+
+
+
+// ************************ batch **************************
+
+/* periods[k] = m_period(cs[k]) */
+void m_period_batch(const m_context *ctx, const m_complex *cs, int *periods, int n);
+
+/* ms[k] = m_multiplier(cs[k], periods[k]) */
+void m_multiplier_batch(const m_context *ctx, const m_complex *cs, const int *periods, m_complex *ms, int n);
+
+/* ms[k] = m_multiplier_seeded(cs[k], periods[k], seeds + k*nSeeds, nSeeds) , nSeeds seeds for every point */
+void m_multiplier_seeded_batch(const m_context *ctx, const m_complex *cs, const int *periods, const m_complex *seeds, int nSeeds, m_complex *ms, int n);
+
+/* ms[k] = m_multiplier_de(cs[k], periods[k], &des[k]) , des can be NULL */
+void m_multiplier_de_batch(const m_context *ctx, const m_complex *cs, const int *periods, m_complex *ms, double *des, int n);
+
+/*
+  multipliers of n points with the same period in mixed precision ( m-mixed.c )
+  float Newton for blocks of points, points with untrustworthy result are recomputed in double
+  returns the number of points recomputed in double
+*/
+int m_multiplier_mixed_batch(const m_context *ctx, const m_complex *cs, m_complex *ms, int n, int period);
+
+/* cs[k] = m_interior(periods[k], centers[k], angles[k], radii[k]) */
+void m_interior_batch(const m_context *ctx, const int *periods, const m_complex *centers, const double *angles, const double *radii, m_complex *cs, int n);
+
+/*
+  polar grid of one component ( c-grid.c ) with radial and angular continuation
+  cs[j*nr + i] = c(r_i, t_j) , r_i = rMax*i/(nr-1) , t_j = j/nt
+  returns the number of grid nodes that were not found ( c = -1000 there ), -1 for a wrong grid size
+*/
+int m_interior_grid(const m_context *ctx, int period, m_complex center, int nr, double rMax, int nt, m_complex *cs);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif